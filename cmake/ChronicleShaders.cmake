@@ -0,0 +1,63 @@
+# Compile shaders at build time and link them into a target, they are found
+# at runtime with chr::renderer::BakedShaders. The shaders are compiled by
+# the chronicle-shader-bake target, load the module with
+# include(ChronicleShaders).
+#
+#   chr_add_shaders(<target>
+#       [ROOT <directory>]
+#       [INCLUDE_DIRECTORIES <directory>...]
+#       [OPTIMIZER_PASSES <spirv-opt flag>...]
+#       SHADERS <file>...)
+#
+# The shader paths are relative to ROOT (the current source directory by
+# default) and are registered as storage paths, ex. "/shader.vert". The
+# include directories are storage paths relative to ROOT too. The stage of a
+# shader comes from its extension: .vert, .frag or .comp. The optimizer passes
+# are run after the compilation, see CompileSharerOptions::optimizer_passes.
+function(chr_add_shaders target)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "" "ROOT"
+        "INCLUDE_DIRECTORIES;OPTIMIZER_PASSES;SHADERS")
+
+    if(ARG_ROOT)
+        get_filename_component(root "${ARG_ROOT}" ABSOLUTE)
+    else()
+        set(root "${CMAKE_CURRENT_SOURCE_DIR}")
+    endif()
+
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders.cc")
+
+    set(shaders "")
+    set(sources "")
+    foreach(shader IN LISTS ARG_SHADERS)
+        list(APPEND shaders "${shader}")
+        list(APPEND sources "${root}/${shader}")
+    endforeach()
+
+    set(include_args "")
+    foreach(directory IN LISTS ARG_INCLUDE_DIRECTORIES)
+        list(APPEND include_args "--include" "${directory}")
+    endforeach()
+
+    set(pass_args "")
+    foreach(pass IN LISTS ARG_OPTIMIZER_PASSES)
+        list(APPEND pass_args "--pass" "${pass}")
+    endforeach()
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND chronicle-shader-bake
+            --root "${root}"
+            --depfile "${output}.d"
+            ${include_args}
+            ${pass_args}
+            "${output}"
+            ${shaders}
+        DEPENDS chronicle-shader-bake ${sources}
+        DEPFILE "${output}.d"
+        COMMENT "Baking shaders of ${target}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${output}")
+    target_link_libraries(${target} PRIVATE chronicle::renderer)
+endfunction()
@@ -23,34 +23,33 @@ auto ExampleApp::Init() -> void {
                    entry.Extension(), entry.HaveExtension(), entry.Size());
   }
 
-  auto triangle_shader_frag = storage.GetFile("/triangle_shader.frag");
-  triangle_shader_frag.Open();
-  auto triangle_shader_frag_data = triangle_shader_frag.ReadAll();
-  triangle_shader_frag.Close();
-
-  auto triangle_shader_vert = storage.GetFile("/triangle_shader.vert");
-  triangle_shader_vert.Open();
-  auto triangle_shader_vert_data = triangle_shader_vert.ReadAll();
-  triangle_shader_vert.Close();
-
-  chr::renderer::ShaderCompiler compiler{};
-
-  auto fragment_shader_compiled =
-      compiler.Compile(triangle_shader_frag_data, "triangle_shader.frag",
-                       chr::renderer::ShaderStage::kFragment);
-
-  auto vertex_shader_compiled =
-      compiler.Compile(triangle_shader_vert_data, "triangle_shader.vert",
-                       chr::renderer::ShaderStage::kVertex);
-
   const auto& device = platform.GetDevice();
   const auto& swap_chain = platform.GetSwapChain();
 
   auto swap_chain_extent = swap_chain->GetExtent();
   auto swap_chain_format = swap_chain->GetFormat();
 
-  fragment_shader_ = device->CreateShader(fragment_shader_compiled.data);
-  vertex_shader_ = device->CreateShader(vertex_shader_compiled.data);
+  // The shaders are compiled at build time, see chr_add_shaders.
+  auto find_shader = [](std::string_view path) {
+    const auto* shader = chr::renderer::BakedShaders::Find(path);
+    if (shader == nullptr) {
+      throw chr::renderer::RendererException(
+          chr::renderer::Error::kInvalidShader,
+          fmt::format("Shader {} is not baked", path));
+    }
+    return shader;
+  };
+  const auto* fragment_shader_baked = find_shader("/triangle_shader.frag");
+  const auto* vertex_shader_baked = find_shader("/triangle_shader.vert");
+
+  fragment_shader_ = device->CreateShader(
+      fragment_shader_baked->data,
+      chr::renderer::ShaderCompiler::Reflect(fragment_shader_baked->data,
+                                             fragment_shader_baked->stage));
+  vertex_shader_ = device->CreateShader(
+      vertex_shader_baked->data,
+      chr::renderer::ShaderCompiler::Reflect(vertex_shader_baked->data,
+                                             vertex_shader_baked->stage));
 
   render_pass_ = device->CreateRenderPass({.format = swap_chain_format});
 
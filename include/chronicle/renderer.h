@@ -5,6 +5,7 @@
 #ifndef CHR_RENDERER_H_
 #define CHR_RENDERER_H_
 
+#include "../../src/renderer/baked_shaders.h"
 #include "../../src/renderer/command_buffer.h"
 #include "../../src/renderer/command_pool.h"
 #include "../../src/renderer/device.h"
@@ -16,7 +17,12 @@
 #include "../../src/renderer/render_pass.h"
 #include "../../src/renderer/semaphore.h"
 #include "../../src/renderer/shader.h"
+#include "../../src/renderer/shader_cache.h"
 #include "../../src/renderer/shader_compiler.h"
+#include "../../src/renderer/shader_dependencies.h"
+#include "../../src/renderer/shader_hot_reload.h"
+#include "../../src/renderer/shader_permutations.h"
+#include "../../src/renderer/shader_reflection.h"
 #include "../../src/renderer/surface.h"
 #include "../../src/renderer/swap_chain.h"
 
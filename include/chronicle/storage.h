@@ -5,6 +5,16 @@
 #ifndef CHR_STORAGE_H_
 #define CHR_STORAGE_H_
 
+#include "../../src/storage/access_trace.h"
+#include "../../src/storage/asset_cache.h"
+#include "../../src/storage/block_cache.h"
+#include "../../src/storage/hash.h"
+#include "../../src/storage/manifest.h"
+#include "../../src/storage/pack_writer.h"
+#include "../../src/storage/path.h"
+#include "../../src/storage/read.h"
+#include "../../src/storage/stats.h"
 #include "../../src/storage/storage.h"
+#include "../../src/storage/watch.h"
 
 #endif  // CHR_RENDERER_H_
\ No newline at end of file
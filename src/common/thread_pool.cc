@@ -0,0 +1,64 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace chr::utils {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  // hardware_concurrency can return zero when the value is not computable.
+  thread_count = std::max<size_t>(thread_count, 1);
+
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(&ThreadPool::Worker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::scoped_lock lock{mutex_};
+    stopping_ = true;
+  }
+
+  condition_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+auto ThreadPool::Enqueue(std::function<void()> task) -> void {
+  {
+    std::scoped_lock lock{mutex_};
+    tasks_.push_back(std::move(task));
+  }
+
+  condition_.notify_one();
+}
+
+auto ThreadPool::Worker() -> void {
+  while (true) {
+    std::function<void()> task{};
+
+    {
+      std::unique_lock lock{mutex_};
+      condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+      // The remaining tasks are executed before stopping.
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+
+}  // namespace chr::utils
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_COMMON_THREAD_POOL_H_
+#define CHR_COMMON_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chr::utils {
+
+//! @brief Fixed set of worker threads that execute the submitted tasks in
+//!        submission order.
+struct ThreadPool {
+  //! @brief Create the pool and start the worker threads.
+  //! @param thread_count Number of worker threads, by default one for each
+  //!                     hardware thread.
+  explicit ThreadPool(
+      size_t thread_count = std::thread::hardware_concurrency());
+
+  //! @brief The copy constructor is not supported.
+  ThreadPool(const ThreadPool&) = delete;
+
+  //! @brief The move constructor is not supported.
+  ThreadPool(ThreadPool&&) noexcept = delete;
+
+  //! @brief Wait for the queued tasks to complete and stop the worker threads.
+  ~ThreadPool();
+
+  //! @brief The copy assignment operator is not supported.
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+  //! @brief Queue a task for execution on a worker thread.
+  //! @param fun Task to execute.
+  //! @return Future that receive the task result (or its exception).
+  template <typename Fun>
+  auto Submit(Fun&& fun) -> std::future<std::invoke_result_t<Fun>> {
+    using Result = std::invoke_result_t<Fun>;
+
+    // std::function needs a copyable target, so the task is shared.
+    auto task =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<Fun>(fun));
+    auto future = task->get_future();
+    Enqueue([task] { (*task)(); });
+    return future;
+  }
+
+  //! @brief Get the number of worker threads.
+  //! @return Number of worker threads.
+  [[nodiscard]] auto ThreadCount() const -> size_t { return threads_.size(); }
+
+ private:
+  auto Enqueue(std::function<void()> task) -> void;
+  auto Worker() -> void;
+
+  std::mutex mutex_{};
+  std::condition_variable condition_{};
+  std::deque<std::function<void()>> tasks_{};
+  bool stopping_{false};
+  std::vector<std::thread> threads_{};
+};
+
+}  // namespace chr::utils
+
+#endif  // CHR_COMMON_THREAD_POOL_H_
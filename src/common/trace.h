@@ -25,6 +25,7 @@
 
 #define CHR_ZONE_SCOPED() ZoneScoped
 #define CHR_ZONE_SCOPED_COLOR(color) ZoneScopedC(color)
+#define CHR_PLOT(name, value) TracyPlot(name, value)
 
 inline void* operator new(std::size_t count) {
   auto ptr = malloc(count);
@@ -40,6 +41,7 @@ inline void operator delete(void* ptr) noexcept {
 
 #define CHR_ZONE_SCOPED()
 #define CHR_ZONE_SCOPED_COLOR(color)
+#define CHR_PLOT(name, value)
 
 #endif
 
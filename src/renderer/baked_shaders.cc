@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "baked_shaders.h"
+
+#include <chronicle/storage.h>
+
+#include <map>
+
+namespace chr::renderer {
+
+// The shaders are registered during the static initialization, the registry
+// is created on first use.
+static auto GetRegistry() -> std::map<std::string_view, BakedShader>& {
+  static std::map<std::string_view, BakedShader> registry{};
+  return registry;
+}
+
+auto BakedShaders::Register(std::span<const BakedShader> shaders) -> void {
+  auto& registry = GetRegistry();
+  for (const auto& shader : shaders) {
+    registry.insert_or_assign(shader.path, shader);
+  }
+}
+
+auto BakedShaders::Find(std::string_view path) -> const BakedShader* {
+  const auto& registry = GetRegistry();
+  auto it = registry.find(storage::NormalizePath(path));
+  return it != registry.end() ? &it->second : nullptr;
+}
+
+auto BakedShaders::GetAll() -> std::vector<BakedShader> {
+  std::vector<BakedShader> shaders{};
+  shaders.reserve(GetRegistry().size());
+  for (const auto& [path, shader] : GetRegistry()) {
+    shaders.push_back(shader);
+  }
+  return shaders;
+}
+
+}  // namespace chr::renderer
\ No newline at end of file
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_BAKED_SHADERS_H_
+#define CHR_RENDERER_BAKED_SHADERS_H_
+
+#include <span>
+
+#include "enums.h"
+#include "pch.h"
+
+namespace chr::renderer {
+
+//! @brief Shader compiled at build time and linked into the executable.
+struct BakedShader {
+  //! @brief Path of the shader source, relative to the root directory passed
+  //!        to chr_add_shaders and normalized as a storage path (ex.
+  //!        "/triangle_shader.vert").
+  std::string_view path{};
+
+  //! @brief Type of the shader (vertex/fragment/etc.).
+  ShaderStage stage{};
+
+  //! @brief Shader compiled binary data.
+  std::span<const uint8_t> data{};
+};
+
+//! @brief Shaders compiled at build time by the chr_add_shaders CMake
+//!        function. The generated code registers them before main, so
+//!        loading a shader is a lookup and needs no compilation. Use
+//!        ShaderCompiler::Reflect to get the interface of a shader.
+struct BakedShaders {
+  //! @brief Register shaders, it's called by the generated code.
+  //! @param shaders Shaders to register, they must have static storage.
+  static auto Register(std::span<const BakedShader> shaders) -> void;
+
+  //! @brief Find a shader.
+  //! @param path Path of the shader source.
+  //! @return Shader, or nullptr if it's not registered.
+  static auto Find(std::string_view path) -> const BakedShader*;
+
+  //! @brief Get all the registered shaders.
+  //! @return Registered shaders, sorted by path.
+  static auto GetAll() -> std::vector<BakedShader>;
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_BAKED_SHADERS_H_
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_includer.h"
+
+namespace chr::renderer::internal {
+
+// Result of an include, shaderc points to the strings until ReleaseInclude.
+struct ShaderIncludeData {
+  shaderc_include_result result{};
+  std::string source_name{};
+  std::vector<uint8_t> content{};
+};
+
+auto ShaderIncluder::GetInclude(const char* requested_source,
+                                shaderc_include_type type,
+                                const char* requesting_source,
+                                size_t /*include_depth*/)
+    -> shaderc_include_result* {
+  CHR_ZONE_SCOPED();
+
+  auto data = std::make_unique<ShaderIncludeData>();
+  auto path = Resolve(storage_, include_directories_, requested_source, type,
+                      requesting_source);
+  if (path.empty()) {
+    // An empty source name reports an error, the content is the message.
+    auto message = fmt::format("Cannot find include file {}", requested_source);
+    data->content.assign(message.begin(), message.end());
+  } else {
+    // The exceptions can't cross the compiler, they are reported as errors.
+    try {
+      auto file = storage_.GetFile(path, storage::FileMode::kStream);
+      file.Open();
+      data->content = file.ReadAll();
+      file.Close();
+      data->source_name = path;
+
+      includes_.push_back({.path = std::move(path),
+                           .included_by = requesting_source,
+                           .requested = requested_source,
+                           .relative = type == shaderc_include_type_relative,
+                           .hash = storage::HashContent(data->content)});
+    } catch (const std::exception& error) {
+      auto message = fmt::format("Cannot read include file {}: {}",
+                                 requested_source, error.what());
+      data->source_name.clear();
+      data->content.assign(message.begin(), message.end());
+    }
+  }
+
+  data->result.source_name = data->source_name.data();
+  data->result.source_name_length = data->source_name.size();
+  data->result.content = std::bit_cast<const char*>(data->content.data());
+  data->result.content_length = data->content.size();
+  data->result.user_data = data.get();
+  return &data.release()->result;
+}
+
+auto ShaderIncluder::ReleaseInclude(shaderc_include_result* data) -> void {
+  delete static_cast<ShaderIncludeData*>(data->user_data);
+}
+
+auto ShaderIncluder::JoinPath(std::string_view directory,
+                              std::string_view path) -> std::string {
+  std::vector<std::string_view> components{};
+  auto add_components = [&components](std::string_view value) {
+    while (!value.empty()) {
+      auto separator = value.find('/');
+      auto component = value.substr(0, separator);
+      if (component == "..") {
+        if (!components.empty()) {
+          components.pop_back();
+        }
+      } else if (!component.empty() && component != ".") {
+        components.push_back(component);
+      }
+      value = separator == std::string_view::npos ? std::string_view{}
+                                                  : value.substr(separator + 1);
+    }
+  };
+
+  if (!path.starts_with('/')) {
+    add_components(directory);
+  }
+  add_components(path);
+
+  std::string joined{};
+  for (auto component : components) {
+    joined += '/';
+    joined += component;
+  }
+
+  return joined.empty() ? "/" : joined;
+}
+
+auto ShaderIncluder::Resolve(const storage::Storage& storage,
+                             std::span<const std::string> include_directories,
+                             std::string_view requested,
+                             shaderc_include_type type,
+                             std::string_view requesting) -> std::string {
+  // #include "file" is searched next to the including file first, then like
+  // #include <file> in the include directories.
+  auto is_file = [&storage](const std::string& path) {
+    auto entry = storage.GetEntry(path);
+    return entry.has_value() && !entry->IsDirectory();
+  };
+
+  if (type == shaderc_include_type_relative) {
+    auto path = JoinPath(
+        storage::ParentPath(storage::NormalizePath(requesting)), requested);
+    if (is_file(path)) {
+      return path;
+    }
+  }
+
+  for (const auto& directory : include_directories) {
+    auto path = JoinPath(directory, requested);
+    if (is_file(path)) {
+      return path;
+    }
+  }
+
+  return {};
+}
+
+}  // namespace chr::renderer::internal
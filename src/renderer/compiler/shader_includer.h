@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_COMPILER_SHADER_INCLUDER_H_
+#define CHR_RENDERER_COMPILER_SHADER_INCLUDER_H_
+
+#include <chronicle/storage.h>
+
+#include <shaderc/shaderc.hpp>
+
+#include "pch.h"
+#include "shader_cache.h"
+
+namespace chr::renderer::internal {
+
+// Resolve the #include directives of a shader with the files of a storage
+// and record every resolved include.
+struct ShaderIncluder : shaderc::CompileOptions::IncluderInterface {
+  explicit ShaderIncluder(const storage::Storage& storage,
+                          std::vector<std::string> include_directories,
+                          std::vector<ShaderInclude>& includes)
+      : storage_{storage},
+        include_directories_{std::move(include_directories)},
+        includes_{includes} {}
+
+  ShaderIncluder(const ShaderIncluder&) = delete;
+  ShaderIncluder(ShaderIncluder&& other) noexcept = delete;
+
+  ~ShaderIncluder() override = default;
+
+  ShaderIncluder& operator=(const ShaderIncluder&) = delete;
+  ShaderIncluder& operator=(ShaderIncluder&& other) noexcept = delete;
+
+  auto GetInclude(const char* requested_source, shaderc_include_type type,
+                  const char* requesting_source, size_t include_depth)
+      -> shaderc_include_result* override;
+  auto ReleaseInclude(shaderc_include_result* data) -> void override;
+
+  // Join a path to a directory, resolving the "." and ".." components.
+  static auto JoinPath(std::string_view directory, std::string_view path)
+      -> std::string;
+
+  // Find the file of an #include directive, an empty path if there is none.
+  static auto Resolve(const storage::Storage& storage,
+                      std::span<const std::string> include_directories,
+                      std::string_view requested, shaderc_include_type type,
+                      std::string_view requesting) -> std::string;
+
+ private:
+  const storage::Storage& storage_;
+  std::vector<std::string> include_directories_;
+  std::vector<ShaderInclude>& includes_;
+};
+
+}  // namespace chr::renderer::internal
+
+#endif  // CHR_RENDERER_COMPILER_SHADER_INCLUDER_H_
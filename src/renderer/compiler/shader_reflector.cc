@@ -0,0 +1,201 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_reflector.h"
+
+#include <spirv_cross.hpp>
+
+namespace chr::renderer::internal {
+
+using spirv_cross::SPIRType;
+
+static auto GetScalarType(const SPIRType& type) -> ScalarType {
+  switch (type.basetype) {
+    case SPIRType::Boolean:
+      return ScalarType::kBool;
+    case SPIRType::Int:
+      return ScalarType::kInt;
+    case SPIRType::UInt:
+      return ScalarType::kUInt;
+    case SPIRType::Float:
+      return ScalarType::kFloat;
+    default:
+      return ScalarType::kOther;
+  }
+}
+
+static auto GetVertexFormat(const SPIRType& type) -> Format {
+  static constexpr std::array kHalfFormats{
+      Format::kR16SFloat, Format::kR16G16SFloat, Format::kR16G16B16SFloat,
+      Format::kR16G16B16A16SFloat};
+  static constexpr std::array kFloatFormats{
+      Format::kR32SFloat, Format::kR32G32SFloat, Format::kR32G32B32SFloat,
+      Format::kR32G32B32A32SFloat};
+  static constexpr std::array kDoubleFormats{
+      Format::kR64SFloat, Format::kR64G64SFloat, Format::kR64G64B64SFloat,
+      Format::kR64G64B64A64SFloat};
+  static constexpr std::array kIntFormats{
+      Format::kR32SInt, Format::kR32G32SInt, Format::kR32G32B32SInt,
+      Format::kR32G32B32A32SInt};
+  static constexpr std::array kUIntFormats{
+      Format::kR32UInt, Format::kR32G32UInt, Format::kR32G32B32UInt,
+      Format::kR32G32B32A32UInt};
+
+  if (type.vecsize < 1 || type.vecsize > 4) {
+    return Format::kUndefined;
+  }
+
+  auto index = type.vecsize - 1;
+  switch (type.basetype) {
+    case SPIRType::Half:
+      return kHalfFormats[index];
+    case SPIRType::Float:
+      return kFloatFormats[index];
+    case SPIRType::Double:
+      return kDoubleFormats[index];
+    case SPIRType::Int:
+      return kIntFormats[index];
+    case SPIRType::UInt:
+      return kUIntFormats[index];
+    default:
+      break;
+  }
+
+  return Format::kUndefined;
+}
+
+static auto GetDescriptorCount(const SPIRType& type) -> uint32_t {
+  // The arrays without a size have a zero length.
+  uint32_t count = 1;
+  for (auto size : type.array) {
+    count *= size;
+  }
+  return count;
+}
+
+static auto AddBindings(
+    const spirv_cross::Compiler& compiler,
+    const spirv_cross::SmallVector<spirv_cross::Resource>& resources,
+    DescriptorType type, std::vector<DescriptorBinding>& bindings) -> void {
+  for (const auto& resource : resources) {
+    const auto& resource_type = compiler.get_type(resource.type_id);
+
+    // The image declarations with a buffer dimension are texel buffers.
+    auto binding_type = type;
+    if (resource_type.basetype == SPIRType::Image &&
+        resource_type.image.dim == spv::DimBuffer) {
+      binding_type = type == DescriptorType::kStorageImage
+                         ? DescriptorType::kStorageTexelBuffer
+                         : DescriptorType::kUniformTexelBuffer;
+    }
+
+    bindings.push_back(
+        {.set = compiler.get_decoration(resource.id,
+                                        spv::DecorationDescriptorSet),
+         .binding = compiler.get_decoration(resource.id,
+                                            spv::DecorationBinding),
+         .type = binding_type,
+         .count = GetDescriptorCount(resource_type),
+         .name = resource.name});
+  }
+}
+
+auto ReflectShader(std::span<const uint8_t> spirv, ShaderStage stage)
+    -> ShaderReflection {
+  CHR_ZONE_SCOPED();
+
+  std::vector<uint32_t> words(spirv.size() / sizeof(uint32_t));
+  std::memcpy(words.data(), spirv.data(), words.size() * sizeof(uint32_t));
+  spirv_cross::Compiler compiler{std::move(words)};
+
+  // Only the resources used by the entry point are bound, the declared but
+  // unused ones don't end in the pipeline layouts.
+  auto active_variables = compiler.get_active_interface_variables();
+  auto resources = compiler.get_shader_resources(active_variables);
+  compiler.set_enabled_interface_variables(std::move(active_variables));
+
+  ShaderReflection reflection{};
+
+  AddBindings(compiler, resources.uniform_buffers,
+              DescriptorType::kUniformBuffer, reflection.bindings);
+  AddBindings(compiler, resources.storage_buffers,
+              DescriptorType::kStorageBuffer, reflection.bindings);
+  AddBindings(compiler, resources.sampled_images,
+              DescriptorType::kCombinedImageSampler, reflection.bindings);
+  AddBindings(compiler, resources.separate_images,
+              DescriptorType::kSampledImage, reflection.bindings);
+  AddBindings(compiler, resources.separate_samplers, DescriptorType::kSampler,
+              reflection.bindings);
+  AddBindings(compiler, resources.storage_images,
+              DescriptorType::kStorageImage, reflection.bindings);
+  AddBindings(compiler, resources.subpass_inputs,
+              DescriptorType::kInputAttachment, reflection.bindings);
+
+  std::ranges::sort(reflection.bindings, [](const auto& a, const auto& b) {
+    return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+  });
+
+  // The push constant range covers only the members used by the shader.
+  for (const auto& resource : resources.push_constant_buffers) {
+    auto ranges = compiler.get_active_buffer_ranges(resource.id);
+    if (ranges.empty()) {
+      continue;
+    }
+
+    auto begin = std::numeric_limits<size_t>::max();
+    size_t end = 0;
+    for (const auto& range : ranges) {
+      begin = std::min(begin, range.offset);
+      end = std::max(end, range.offset + range.range);
+    }
+
+    reflection.push_constants.push_back(
+        {.offset = static_cast<uint32_t>(begin),
+         .size = static_cast<uint32_t>(end - begin)});
+  }
+
+  if (stage == ShaderStage::kVertex) {
+    for (const auto& resource : resources.stage_inputs) {
+      if (compiler.has_decoration(resource.id, spv::DecorationBuiltIn)) {
+        continue;
+      }
+
+      const auto& type = compiler.get_type(resource.type_id);
+      auto location =
+          compiler.get_decoration(resource.id, spv::DecorationLocation);
+
+      // The matrices take a location for every column.
+      for (uint32_t column = 0; column < type.columns; ++column) {
+        reflection.vertex_inputs.push_back(
+            {.location = location + column,
+             .format = GetVertexFormat(type),
+             .size = type.width / 8 * type.vecsize,
+             .name = resource.name});
+      }
+    }
+
+    std::ranges::sort(reflection.vertex_inputs, {}, &VertexInput::location);
+  }
+
+  for (const auto& constant : compiler.get_specialization_constants()) {
+    const auto& type =
+        compiler.get_type(compiler.get_constant(constant.id).constant_type);
+
+    // The booleans are passed as 32 bit values.
+    reflection.specialization_constants.push_back(
+        {.id = constant.constant_id,
+         .size = type.basetype == SPIRType::Boolean
+                     ? static_cast<uint32_t>(sizeof(uint32_t))
+                     : type.width / 8,
+         .type = GetScalarType(type),
+         .name = compiler.get_name(constant.id)});
+  }
+
+  std::ranges::sort(reflection.specialization_constants, {},
+                    &SpecializationConstant::id);
+
+  return reflection;
+}
+
+}  // namespace chr::renderer::internal
\ No newline at end of file
@@ -0,0 +1,21 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_COMPILER_SHADER_REFLECTOR_H_
+#define CHR_RENDERER_COMPILER_SHADER_REFLECTOR_H_
+
+#include <span>
+
+#include "pch.h"
+#include "shader_reflection.h"
+
+namespace chr::renderer::internal {
+
+// Read the interface of a shader from its SPIR-V code.
+auto ReflectShader(std::span<const uint8_t> spirv, ShaderStage stage)
+    -> ShaderReflection;
+
+}  // namespace chr::renderer::internal
+
+#endif  // CHR_RENDERER_COMPILER_SHADER_REFLECTOR_H_
\ No newline at end of file
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "spirv_optimizer.h"
+
+#include <spirv-tools/optimizer.hpp>
+
+namespace chr::renderer::internal {
+
+// Words of the SPIR-V module header, the instructions follow it.
+constexpr size_t kSpirvHeaderSize = 5;
+
+auto GetSpirvStats(std::span<const uint8_t> spirv) -> SpirvStats {
+  SpirvStats stats{.size = spirv.size()};
+
+  // The high half of the first word of an instruction is its word count.
+  auto word_count = spirv.size() / sizeof(uint32_t);
+  for (auto index = kSpirvHeaderSize; index < word_count;) {
+    uint32_t word = 0;
+    std::memcpy(&word, spirv.data() + index * sizeof(uint32_t), sizeof(word));
+    if ((word >> 16) == 0) {
+      break;
+    }
+
+    stats.instruction_count++;
+    index += word >> 16;
+  }
+
+  return stats;
+}
+
+auto OptimizeSpirv(const std::vector<std::string>& passes,
+                   CompileShaderResult& result) -> bool {
+  CHR_ZONE_SCOPED();
+
+  auto start = std::chrono::steady_clock::now();
+
+  spvtools::Optimizer optimizer{SPV_ENV_VULKAN_1_2};
+  optimizer.SetMessageConsumer([&result](spv_message_level_t level,
+                                         const char* /*source*/,
+                                         const spv_position_t& /*position*/,
+                                         const char* message) {
+    if (level <= SPV_MSG_ERROR) {
+      log::Err("{}", message);
+      result.errors.emplace_back(message);
+    } else if (level == SPV_MSG_WARNING) {
+      log::Warn("{}", message);
+      result.warnings.emplace_back(message);
+    }
+  });
+
+  for (const auto& pass : passes) {
+    if (!optimizer.RegisterPassFromFlag(pass)) {
+      result.errors.push_back(fmt::format("Invalid optimizer pass {}", pass));
+      result.success = false;
+      return false;
+    }
+  }
+
+  std::vector<uint32_t> words(result.data.size() / sizeof(uint32_t));
+  std::memcpy(words.data(), result.data.data(),
+              words.size() * sizeof(uint32_t));
+
+  std::vector<uint32_t> optimized{};
+  if (!optimizer.Run(words.data(), words.size(), &optimized)) {
+    result.errors.emplace_back("Failed to optimize the shader");
+    result.success = false;
+    return false;
+  }
+
+  result.data.resize(optimized.size() * sizeof(uint32_t));
+  std::memcpy(result.data.data(), optimized.data(), result.data.size());
+  result.optimization_time = std::chrono::steady_clock::now() - start;
+
+  return true;
+}
+
+}  // namespace chr::renderer::internal
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_COMPILER_SPIRV_OPTIMIZER_H_
+#define CHR_RENDERER_COMPILER_SPIRV_OPTIMIZER_H_
+
+#include <span>
+
+#include "pch.h"
+#include "shader_compiler.h"
+
+namespace chr::renderer::internal {
+
+// Get the size and the number of instructions of a SPIR-V module.
+auto GetSpirvStats(std::span<const uint8_t> spirv) -> SpirvStats;
+
+// Run the spirv-tools optimizer passes on a compiled shader, the data of the
+// result is replaced by the optimized module. On failure the errors are added
+// to the result, the success flag is cleared and false is returned.
+auto OptimizeSpirv(const std::vector<std::string>& passes,
+                   CompileShaderResult& result) -> bool;
+
+}  // namespace chr::renderer::internal
+
+#endif  // CHR_RENDERER_COMPILER_SPIRV_OPTIMIZER_H_
\ No newline at end of file
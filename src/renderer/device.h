@@ -5,6 +5,8 @@
 #ifndef CHR_RENDERER_DEVICE_H_
 #define CHR_RENDERER_DEVICE_H_
 
+#include <span>
+
 #include "command_buffer.h"
 #include "command_pool.h"
 #include "common.h"
@@ -53,9 +55,16 @@ struct DeviceI {
   virtual ~DeviceI() = default;
 
   //! @brief Create a new shader modules.
-  //! @param data Shader binary data (already compiled).
+  //! @param data Shader binary data (already compiled), it's only read
+  //!             during the call.
+  //! @param reflection Interface of the shader, see
+  //!                   CompileShaderResult::reflection. The pipelines build
+  //!                   their layouts and vertex input from it, see
+  //!                   ShaderCompiler::Reflect for the binaries that are
+  //!                   not compiled at runtime.
   //! @return A shared pointer to the ShaderI instance.
-  virtual auto CreateShader(const std::vector<uint8_t>& data) const
+  virtual auto CreateShader(std::span<const uint8_t> data,
+                            const ShaderReflection& reflection) const
       -> Shader = 0;
 
   //! @brief Create a new swapchain.
@@ -66,7 +75,10 @@ struct DeviceI {
                                const SwapChainCreateInfo& info) const
       -> SwapChain = 0;
 
-  //! @brief Create a new pipeline.
+  //! @brief Create a new pipeline. The descriptor set layouts, the push
+  //!        constant ranges and the vertex input are built from the
+  //!        reflection of the shaders, the layouts are shared by all the
+  //!        pipelines with the same interface.
   //! @param render_pass Render pass used to create the new pipeline.
   //! @param info Informations used to create a new pipeline.
   //! @return A shared pointer to the PipelineI instance.
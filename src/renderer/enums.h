@@ -32,6 +32,34 @@ enum class ShaderStage {
   kAll           //!< All stages.
 };
 
+//! @brief Type of a resource bound to a descriptor.
+enum class DescriptorType {
+  kSampler,               //!< Sampler.
+  kCombinedImageSampler,  //!< Image and sampler combined.
+  kSampledImage,          //!< Image read through a sampler.
+  kStorageImage,          //!< Image with load and store access.
+  kUniformTexelBuffer,    //!< Read-only formatted buffer.
+  kStorageTexelBuffer,    //!< Formatted buffer with load and store access.
+  kUniformBuffer,         //!< Uniform buffer.
+  kStorageBuffer,         //!< Storage buffer.
+  kInputAttachment        //!< Attachment of the render pass.
+};
+
+//! @brief Rate at which a vertex buffer advances.
+enum class VertexInputRate {
+  kVertex,   //!< The buffer advances for every vertex.
+  kInstance  //!< The buffer advances for every instance.
+};
+
+//! @brief Scalar type of a shader value.
+enum class ScalarType {
+  kBool,   //!< Boolean.
+  kInt,    //!< Signed integer.
+  kUInt,   //!< Unsigned integer.
+  kFloat,  //!< Floating point.
+  kOther   //!< Any other type (ex. doubles and 64 bit integers).
+};
+
 //! @brief Status about a fence.
 enum class FenceStatus {
   kSignaled,    //!< Fence is signaled.
@@ -0,0 +1,36 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "pipeline.h"
+
+namespace chr::renderer {
+
+// Alignment of the attributes of an interleaved layout.
+constexpr uint32_t kVertexAttributeAlignment = 4;
+
+auto VertexLayout::Interleaved(const ShaderReflection& reflection)
+    -> VertexLayout {
+  VertexLayout layout{};
+  if (reflection.vertex_inputs.empty()) {
+    return layout;
+  }
+
+  uint32_t offset = 0;
+  for (const auto& input : reflection.vertex_inputs) {
+    offset = (offset + kVertexAttributeAlignment - 1) /
+             kVertexAttributeAlignment * kVertexAttributeAlignment;
+    layout.attributes.push_back({.location = input.location,
+                                 .binding = 0,
+                                 .format = input.format,
+                                 .offset = offset});
+    offset += input.size;
+  }
+
+  auto stride = (offset + kVertexAttributeAlignment - 1) /
+                kVertexAttributeAlignment * kVertexAttributeAlignment;
+  layout.buffers.push_back({.binding = 0, .stride = stride});
+  return layout;
+}
+
+}  // namespace chr::renderer
\ No newline at end of file
@@ -5,11 +5,60 @@
 #ifndef CHR_RENDERER_PIPELINE_H_
 #define CHR_RENDERER_PIPELINE_H_
 
+#include <variant>
+
 #include "common.h"
 #include "shader.h"
 
 namespace chr::renderer {
 
+//! @brief Value of a specialization constant. The booleans are passed as 32
+//!        bit values.
+using SpecializationValue = std::variant<bool, int32_t, uint32_t, float>;
+
+//! @brief Vertex buffer read by a pipeline.
+struct VertexBufferLayout {
+  //! @brief Binding of the buffer.
+  uint32_t binding{0};
+
+  //! @brief Distance in bytes between two consecutive elements.
+  uint32_t stride{0};
+
+  //! @brief Rate at which the buffer advances.
+  VertexInputRate input_rate{VertexInputRate::kVertex};
+};
+
+//! @brief Vertex attribute read from a vertex buffer.
+struct VertexAttribute {
+  //! @brief Location of the input in the vertex shader.
+  uint32_t location{0};
+
+  //! @brief Binding of the buffer that contains the attribute.
+  uint32_t binding{0};
+
+  //! @brief Format of the attribute in the buffer.
+  Format format{Format::kUndefined};
+
+  //! @brief Offset in bytes of the attribute inside an element.
+  uint32_t offset{0};
+};
+
+//! @brief Layout of the vertex buffers read by a pipeline.
+struct VertexLayout {
+  //! @brief Vertex buffers.
+  std::vector<VertexBufferLayout> buffers{};
+
+  //! @brief Vertex attributes.
+  std::vector<VertexAttribute> attributes{};
+
+  //! @brief Build a layout with a single buffer at binding 0, that contains
+  //!        all the inputs of a vertex shader interleaved in location order.
+  //!        Every attribute is aligned to 4 bytes.
+  //! @param reflection Reflection of the vertex shader.
+  //! @return Vertex layout.
+  static auto Interleaved(const ShaderReflection& reflection) -> VertexLayout;
+};
+
 //! @brief Informations used to create a new pipeline.
 struct PipelineCreateInfo {
   //! @brief Shaders attached to the pipeline.
@@ -20,6 +69,20 @@ struct PipelineCreateInfo {
 
   //! @brief Scissor size.
   glm::u32vec2 scissor{};
+
+  //! @brief Layout of the vertex buffers, it must provide every input of the
+  //!        vertex shader (see VertexLayout::Interleaved). It's empty for the
+  //!        shaders without inputs.
+  VertexLayout vertex_layout{};
+
+  //! @brief Values of the specialization constants, by constant id. They are
+  //!        applied to every stage that declares the constant (see
+  //!        ShaderReflection::specialization_constants), the other constants
+  //!        keep the default value of the shader. Pipelines that differ only
+  //!        by these values share the same compiled shaders. Every value
+  //!        must have the type of its constant
+  //!        (SpecializationConstant::type).
+  std::unordered_map<uint32_t, SpecializationValue> specialization_constants{};
 };
 
 //! @brief Pipeline.
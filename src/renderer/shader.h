@@ -6,12 +6,17 @@
 #define CHR_RENDERER_SHADER_H_
 
 #include "common.h"
+#include "shader_reflection.h"
 
 namespace chr::renderer {
 
 //! @brief Shader module.
 struct ShaderI {
   virtual ~ShaderI() = default;
+
+  //! @brief Get the interface of the shader.
+  //! @return Reflection passed to DeviceI::CreateShader.
+  virtual auto GetReflection() const -> const ShaderReflection& = 0;
 };
 
 //! @brief Shared pointer to a ShaderI.
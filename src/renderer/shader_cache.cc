@@ -0,0 +1,353 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_cache.h"
+
+#include <fstream>
+#include <thread>
+
+namespace chr::renderer {
+
+constexpr std::array<char, 4> kShaderCacheMagic{'C', 'H', 'R', 'S'};
+constexpr uint32_t kShaderCacheVersion = 6;
+
+// Every cache file starts with a header, so truncated files and files of
+// another version are treated as misses. The header is followed by the
+// SPIR-V binary and the includes, every one is a ShaderCacheInclude followed
+// by the two paths and the requested name. The reflection follows, so a hit
+// doesn't parse the binary again: the bindings, the push constant ranges, the
+// vertex inputs and the specialization constants, the records with a name
+// are followed by it.
+struct ShaderCacheHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  ShaderCacheKey key;
+  uint64_t size;
+  uint64_t include_count;
+  SpirvStats unoptimized;
+  SpirvStats optimized;
+  uint32_t binding_count;
+  uint32_t push_constant_count;
+  uint32_t vertex_input_count;
+  uint32_t specialization_constant_count;
+};
+
+struct ShaderCacheInclude {
+  storage::ContentHash hash;
+  uint32_t path_size;
+  uint32_t included_by_size;
+  uint32_t requested_size;
+  uint32_t relative;
+};
+
+struct ShaderCacheBinding {
+  uint32_t set;
+  uint32_t binding;
+  uint32_t type;
+  uint32_t count;
+  uint32_t name_size;
+};
+
+struct ShaderCacheVertexInput {
+  uint32_t location;
+  uint32_t format;
+  uint32_t size;
+  uint32_t name_size;
+};
+
+struct ShaderCacheConstant {
+  uint32_t id;
+  uint32_t size;
+  uint32_t type;
+  uint32_t name_size;
+};
+
+// Sequential reads from a cache file that fail at the end of the data.
+struct ShaderCacheReader {
+  std::span<const uint8_t> data;
+
+  template <typename T>
+  auto Read(T& value) -> bool {
+    if (data.size() < sizeof(T)) {
+      return false;
+    }
+
+    std::memcpy(&value, data.data(), sizeof(T));
+    data = data.subspan(sizeof(T));
+    return true;
+  }
+
+  auto Read(size_t size, std::span<const uint8_t>& value) -> bool {
+    if (data.size() < size) {
+      return false;
+    }
+
+    value = data.first(size);
+    data = data.subspan(size);
+    return true;
+  }
+
+  auto Read(size_t size, std::string& value) -> bool {
+    std::span<const uint8_t> chars{};
+    if (!Read(size, chars)) {
+      return false;
+    }
+
+    value.assign(chars.begin(), chars.end());
+    return true;
+  }
+};
+
+static auto ParseEntry(ShaderCacheKey key, std::span<const uint8_t> data)
+    -> std::optional<ShaderCacheEntry> {
+  ShaderCacheReader reader{data};
+  ShaderCacheHeader header{};
+  if (!reader.Read(header) || header.magic != kShaderCacheMagic ||
+      header.version != kShaderCacheVersion || header.key != key) {
+    return std::nullopt;
+  }
+
+  ShaderCacheEntry entry{.unoptimized = header.unoptimized,
+                         .optimized = header.optimized};
+  std::span<const uint8_t> binary{};
+  if (!reader.Read(header.size, binary)) {
+    return std::nullopt;
+  }
+  entry.data.assign(binary.begin(), binary.end());
+
+  for (uint64_t i = 0; i < header.include_count; i++) {
+    ShaderCacheInclude include_header{};
+    auto& include = entry.includes.emplace_back();
+    if (!reader.Read(include_header) ||
+        !reader.Read(include_header.path_size, include.path) ||
+        !reader.Read(include_header.included_by_size, include.included_by) ||
+        !reader.Read(include_header.requested_size, include.requested)) {
+      return std::nullopt;
+    }
+    include.relative = include_header.relative != 0;
+    include.hash = include_header.hash;
+  }
+
+  auto& reflection = entry.reflection;
+  for (uint32_t i = 0; i < header.binding_count; i++) {
+    ShaderCacheBinding record{};
+    auto& binding = reflection.bindings.emplace_back();
+    if (!reader.Read(record) || !reader.Read(record.name_size, binding.name)) {
+      return std::nullopt;
+    }
+    binding.set = record.set;
+    binding.binding = record.binding;
+    binding.type = static_cast<DescriptorType>(record.type);
+    binding.count = record.count;
+  }
+
+  for (uint32_t i = 0; i < header.push_constant_count; i++) {
+    if (!reader.Read(reflection.push_constants.emplace_back())) {
+      return std::nullopt;
+    }
+  }
+
+  for (uint32_t i = 0; i < header.vertex_input_count; i++) {
+    ShaderCacheVertexInput record{};
+    auto& input = reflection.vertex_inputs.emplace_back();
+    if (!reader.Read(record) || !reader.Read(record.name_size, input.name)) {
+      return std::nullopt;
+    }
+    input.location = record.location;
+    input.format = static_cast<Format>(record.format);
+    input.size = record.size;
+  }
+
+  for (uint32_t i = 0; i < header.specialization_constant_count; i++) {
+    ShaderCacheConstant record{};
+    auto& constant = reflection.specialization_constants.emplace_back();
+    if (!reader.Read(record) ||
+        !reader.Read(record.name_size, constant.name)) {
+      return std::nullopt;
+    }
+    constant.id = record.id;
+    constant.size = record.size;
+    constant.type = static_cast<ScalarType>(record.type);
+  }
+
+  return entry;
+}
+
+// Write a record to a cache file.
+template <typename T>
+static auto WriteRecord(std::ofstream& stream, const T& value) -> void {
+  stream.write(std::bit_cast<const char*>(&value), sizeof(value));
+}
+
+static auto GetCacheFileName(ShaderCacheKey key) -> std::string {
+  return fmt::format("{:016x}.spv", key);
+}
+
+ShaderCache::ShaderCache(const std::filesystem::path& directory)
+    : directory_(directory) {
+  std::filesystem::create_directories(directory_);
+  storage_.SetBasePath(directory_.string());
+}
+
+auto ShaderCache::Find(
+    ShaderCacheKey key,
+    const std::function<bool(const ShaderCacheEntry&)>& validate)
+    -> std::optional<ShaderCacheEntry> {
+  CHR_ZONE_SCOPED();
+
+  // The file is opened by name, without listing the directory, a missing
+  // file fails to open.
+  std::optional<ShaderCacheEntry> entry{};
+  try {
+    auto file = storage_.GetFile("/" + GetCacheFileName(key),
+                                 storage::FileMode::kMapped);
+    file.Open();
+    entry = ParseEntry(key, file.Map());
+  } catch (const std::exception&) {
+    entry.reset();
+  }
+
+  // The validation reads the included files, it runs without the lock so
+  // the hits of many threads are not serialized.
+  auto hit = entry.has_value() && (!validate || validate(*entry));
+
+  std::lock_guard lock{mutex_};
+  if (!hit) {
+    stats_.misses++;
+    return std::nullopt;
+  }
+
+  stats_.hits++;
+  return entry;
+}
+
+auto ShaderCache::Store(ShaderCacheKey key, const ShaderCacheEntry& entry)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  auto name = GetCacheFileName(key);
+  const auto& reflection = entry.reflection;
+  ShaderCacheHeader header{
+      .magic = kShaderCacheMagic,
+      .version = kShaderCacheVersion,
+      .key = key,
+      .size = entry.data.size(),
+      .include_count = entry.includes.size(),
+      .unoptimized = entry.unoptimized,
+      .optimized = entry.optimized,
+      .binding_count = static_cast<uint32_t>(reflection.bindings.size()),
+      .push_constant_count =
+          static_cast<uint32_t>(reflection.push_constants.size()),
+      .vertex_input_count =
+          static_cast<uint32_t>(reflection.vertex_inputs.size()),
+      .specialization_constant_count = static_cast<uint32_t>(
+          reflection.specialization_constants.size())};
+
+  // The file is written aside and renamed, so a crash never leaves a partial
+  // file with the final name. Every thread has its own temporary file.
+  auto temp_path =
+      directory_ / fmt::format("{}.{}.tmp", name,
+                               std::hash<std::thread::id>{}(
+                                   std::this_thread::get_id()));
+  try {
+    std::ofstream stream{};
+    stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    stream.open(temp_path, std::ios::binary | std::ios::trunc);
+    WriteRecord(stream, header);
+    stream.write(std::bit_cast<const char*>(entry.data.data()),
+                 static_cast<std::streamsize>(entry.data.size()));
+    for (const auto& include : entry.includes) {
+      WriteRecord(stream,
+                  ShaderCacheInclude{
+                      .hash = include.hash,
+                      .path_size = static_cast<uint32_t>(include.path.size()),
+                      .included_by_size =
+                          static_cast<uint32_t>(include.included_by.size()),
+                      .requested_size =
+                          static_cast<uint32_t>(include.requested.size()),
+                      .relative = include.relative ? 1U : 0U});
+      stream << include.path << include.included_by << include.requested;
+    }
+
+    for (const auto& binding : reflection.bindings) {
+      WriteRecord(stream,
+                  ShaderCacheBinding{
+                      .set = binding.set,
+                      .binding = binding.binding,
+                      .type = static_cast<uint32_t>(binding.type),
+                      .count = binding.count,
+                      .name_size = static_cast<uint32_t>(binding.name.size())});
+      stream << binding.name;
+    }
+
+    for (const auto& range : reflection.push_constants) {
+      WriteRecord(stream, range);
+    }
+
+    for (const auto& input : reflection.vertex_inputs) {
+      WriteRecord(stream,
+                  ShaderCacheVertexInput{
+                      .location = input.location,
+                      .format = static_cast<uint32_t>(input.format),
+                      .size = input.size,
+                      .name_size = static_cast<uint32_t>(input.name.size())});
+      stream << input.name;
+    }
+
+    for (const auto& constant : reflection.specialization_constants) {
+      WriteRecord(stream, ShaderCacheConstant{
+                              .id = constant.id,
+                              .size = constant.size,
+                              .type = static_cast<uint32_t>(constant.type),
+                              .name_size =
+                                  static_cast<uint32_t>(constant.name.size())});
+      stream << constant.name;
+    }
+    stream.close();
+
+    std::filesystem::rename(temp_path, directory_ / name);
+  } catch (const std::exception& e) {
+    // The shader is compiled anyway, a cache that can't be written only
+    // costs the next compilation.
+    log::Warn("Failed to store shader {} in the cache: {}", name, e.what());
+
+    std::error_code error{};
+    std::filesystem::remove(temp_path, error);
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  stats_.stores++;
+}
+
+auto ShaderCache::Invalidate(ShaderCacheKey key) -> void {
+  auto name = GetCacheFileName(key);
+
+  if (std::filesystem::remove(directory_ / name)) {
+    std::lock_guard lock{mutex_};
+    stats_.invalidations++;
+  }
+}
+
+auto ShaderCache::Clear() -> void {
+  CHR_ZONE_SCOPED();
+
+  uint64_t removed = 0;
+  for (const auto& entry : std::filesystem::directory_iterator{directory_}) {
+    if (entry.path().extension() == ".spv" &&
+        std::filesystem::remove(entry.path())) {
+      removed++;
+    }
+  }
+
+  std::lock_guard lock{mutex_};
+  stats_.invalidations += removed;
+}
+
+auto ShaderCache::GetStats() const -> ShaderCacheStats {
+  std::lock_guard lock{mutex_};
+  return stats_;
+}
+
+}  // namespace chr::renderer
@@ -0,0 +1,148 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_SHADER_CACHE_H_
+#define CHR_RENDERER_SHADER_CACHE_H_
+
+#include <chronicle/storage.h>
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "pch.h"
+#include "shader_reflection.h"
+
+namespace chr::renderer {
+
+//! @brief Key of a compiled shader, see ShaderCompiler::GetCacheKey.
+using ShaderCacheKey = uint64_t;
+
+//! @brief File included by a shader, see ShaderCompiler::SetIncludeStorage.
+struct ShaderInclude {
+  //! @brief Normalized storage path of the included file.
+  std::string path{};
+
+  //! @brief Path of the file with the #include directive (the shader file
+  //!        name for the includes of the shader itself).
+  std::string included_by{};
+
+  //! @brief Name in the #include directive.
+  std::string requested{};
+
+  //! @brief Whether the directive is #include "file", searched next to the
+  //!        including file before the include directories.
+  bool relative{false};
+
+  //! @brief Hash of the included file content, see storage::HashContent.
+  storage::ContentHash hash{0};
+};
+
+//! @brief Size of a SPIR-V module.
+struct SpirvStats {
+  //! @brief Size in bytes.
+  size_t size{0};
+
+  //! @brief Number of instructions.
+  size_t instruction_count{0};
+};
+
+//! @brief Compiled shader in a ShaderCache.
+struct ShaderCacheEntry {
+  //! @brief SPIR-V binary.
+  std::vector<uint8_t> data{};
+
+  //! @brief Files included by the shader source.
+  std::vector<ShaderInclude> includes{};
+
+  //! @brief Interface of the shader, see ShaderCompiler::Reflect.
+  ShaderReflection reflection{};
+
+  //! @brief SPIR-V generated by the compiler, before the optimizer passes.
+  SpirvStats unoptimized{};
+
+  //! @brief SPIR-V of the shader, after the optimizer passes.
+  SpirvStats optimized{};
+};
+
+//! @brief Counters of a ShaderCache.
+struct ShaderCacheStats {
+  //! @brief Shaders found in the cache.
+  uint64_t hits{0};
+
+  //! @brief Shaders not found in the cache, or found but rejected because
+  //!        an included file changed.
+  uint64_t misses{0};
+
+  //! @brief Shaders added to the cache.
+  uint64_t stores{0};
+
+  //! @brief Shaders removed with Invalidate or Clear.
+  uint64_t invalidations{0};
+};
+
+//! @brief Persistent cache of compiled shaders, see ShaderCompiler::SetCache.
+//!        Every shader is a file in the cache directory, named after its
+//!        key. The files are opened by name through a storage::Storage, so a
+//!        hit costs the copy of a mapped file and no directory listing.
+//!        It's safe to call the methods from many threads.
+struct ShaderCache {
+  //! @brief Open the cache, the directory is created if it doesn't exist.
+  //! @param directory Cache directory on the local filesystem.
+  explicit ShaderCache(const std::filesystem::path& directory);
+
+  //! @brief The copy constructor is not supported.
+  ShaderCache(const ShaderCache&) = delete;
+
+  //! @brief The move constructor is not supported.
+  ShaderCache(ShaderCache&&) noexcept = delete;
+
+  ~ShaderCache() = default;
+
+  //! @brief The copy assignment operator is not supported.
+  ShaderCache& operator=(const ShaderCache&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  ShaderCache& operator=(ShaderCache&&) noexcept = delete;
+
+  //! @brief Get a compiled shader.
+  //! @param key Shader key.
+  //! @param validate Optional check of the cached shader, it's used to
+  //!                 reject the shaders whose included files changed.
+  //! @return Cached shader, or an empty optional if it's not in the cache or
+  //!         it's rejected.
+  auto Find(ShaderCacheKey key,
+            const std::function<bool(const ShaderCacheEntry&)>& validate = {})
+      -> std::optional<ShaderCacheEntry>;
+
+  //! @brief Add a compiled shader, an existing one with the same key is
+  //!        replaced. A failure to write the file is logged and the shader is
+  //!        not cached.
+  //! @param key Shader key.
+  //! @param entry Compiled shader.
+  auto Store(ShaderCacheKey key, const ShaderCacheEntry& entry) -> void;
+
+  //! @brief Remove a compiled shader.
+  //! @param key Shader key.
+  auto Invalidate(ShaderCacheKey key) -> void;
+
+  //! @brief Remove all the compiled shaders.
+  auto Clear() -> void;
+
+  //! @brief Get the counters of the cache.
+  //! @return Cache statistics.
+  [[nodiscard]] auto GetStats() const -> ShaderCacheStats;
+
+ private:
+  std::filesystem::path directory_;
+  storage::Storage storage_{storage::BackendType::kFileSystem};
+  mutable std::mutex mutex_{};
+  ShaderCacheStats stats_{};
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_SHADER_CACHE_H_
@@ -6,13 +6,18 @@
 
 #include <regex>
 #include <shaderc/shaderc.hpp>
-#include <spirv_cross.hpp>
 #include <spirv_glsl.hpp>
 
+#include "compiler/shader_includer.h"
+#include "compiler/shader_reflector.h"
+#include "compiler/spirv_optimizer.h"
 #include "shader.h"
 
 namespace chr::renderer {
 
+// Version of the compiled shaders, see ShaderCompiler::GetCacheKey.
+constexpr uint64_t kCompilerVersion = 1;
+
 static shaderc_shader_kind GetSpirvShader(ShaderStage stage) {
   switch (stage) {
     case ShaderStage::kVertex:
@@ -63,12 +68,95 @@ static shaderc_optimization_level GetSpirvOptimizationLevel(
   return static_cast<shaderc_optimization_level>(0);
 }
 
-auto ShaderCompiler::Compile(std::vector<uint8_t> source,
+// shaderc::Compiler owns the state of the compiler library, every thread
+// keeps its own instance instead of creating one for every shader.
+static auto GetThreadCompiler() -> const shaderc::Compiler& {
+  thread_local const shaderc::Compiler compiler{};
+  return compiler;
+}
+
+auto ShaderCompiler::GetCacheKey(std::span<const uint8_t> source,
+                                 std::string_view filename, ShaderStage type,
+                                 const CompileSharerOptions& options)
+    -> ShaderCacheKey {
+  // The SPIR-V version identifies the shaderc release, kCompilerVersion must
+  // be increased when the code generation changes in other ways.
+  unsigned int spirv_version = 0;
+  unsigned int spirv_revision = 0;
+  shaderc_get_spv_version(&spirv_version, &spirv_revision);
+
+  // The directory of the shader and the include directories select the
+  // included files.
+  auto directories = std::string{
+      storage::ParentPath(storage::NormalizePath(filename))};
+  for (const auto& directory : options.include_directories) {
+    directories += '\n';
+    directories += directory;
+  }
+
+  std::string definitions{};
+  for (const auto& [name, value] : options.definitions) {
+    definitions += fmt::format("{}={}\n", name, value);
+  }
+
+  std::string optimizer_passes{};
+  for (const auto& pass : options.optimizer_passes) {
+    optimizer_passes += pass;
+    optimizer_passes += '\n';
+  }
+
+  std::array<uint64_t, 11> fields{
+      kCompilerVersion,
+      spirv_version,
+      spirv_revision,
+      static_cast<uint64_t>(type),
+      static_cast<uint64_t>(options.optimization),
+      static_cast<uint64_t>(options.language),
+      options.warning_as_errors ? 1U : 0U,
+      storage::HashContent(
+          {std::bit_cast<const uint8_t*>(directories.data()),
+           directories.size()}),
+      storage::HashContent(
+          {std::bit_cast<const uint8_t*>(definitions.data()),
+           definitions.size()}),
+      storage::HashContent(
+          {std::bit_cast<const uint8_t*>(optimizer_passes.data()),
+           optimizer_passes.size()}),
+      storage::HashContent(source)};
+  return storage::HashContent(
+      {std::bit_cast<const uint8_t*>(fields.data()), sizeof(fields)});
+}
+
+auto ShaderCompiler::Compile(std::span<const uint8_t> source,
                              const std::string& filename, ShaderStage type,
                              CompileSharerOptions options) const
     -> CompileShaderResult {
+  CHR_ZONE_SCOPED();
+
   CompileShaderResult result;
-  shaderc::Compiler spriv_compiler;
+
+  ShaderCacheKey cache_key = 0;
+  if (cache_ != nullptr) {
+    cache_key = GetCacheKey(source, filename, type, options);
+    if (auto entry = cache_->Find(
+            cache_key,
+            [this, &options](const auto& entry) {
+              return IsCacheValid(entry, options.include_directories);
+            });
+        entry.has_value()) {
+      log::Debug("Shader {} loaded from cache", filename);
+      result.success = true;
+      result.cached = true;
+      result.data = std::move(entry->data);
+      result.includes = std::move(entry->includes);
+      result.reflection = std::move(entry->reflection);
+      result.unoptimized = entry->unoptimized;
+      result.optimized = entry->optimized;
+      return result;
+    }
+  }
+
+  const auto& spriv_compiler = GetThreadCompiler();
   shaderc::CompileOptions spirv_options;
 
   spirv_options.SetTargetEnvironment(shaderc_target_env_vulkan,
@@ -81,9 +169,18 @@ auto ShaderCompiler::Compile(std::vector<uint8_t> source,
     spirv_options.SetWarningsAsErrors();
   }
 
+  for (const auto& [name, value] : options.definitions) {
+    spirv_options.AddMacroDefinition(name, value);
+  }
+
+  if (include_storage_ != nullptr) {
+    spirv_options.SetIncluder(std::make_unique<internal::ShaderIncluder>(
+        *include_storage_, options.include_directories, result.includes));
+  }
+
   auto spirv_compiler_result = spriv_compiler.CompileGlslToSpv(
-      std::bit_cast<char*>(source.data()), source.size(), GetSpirvShader(type),
-      filename.c_str(), spirv_options);
+      std::bit_cast<const char*>(source.data()), source.size(),
+      GetSpirvShader(type), filename.c_str(), spirv_options);
 
   result.success = spirv_compiler_result.GetCompilationStatus() ==
                    shaderc_compilation_status_success;
@@ -110,7 +207,128 @@ auto ShaderCompiler::Compile(std::vector<uint8_t> source,
       (spirv_compiler_result.end() - spirv_compiler_result.begin()) * 4);
   memcpy(result.data.data(), spirv_compiler_result.begin(), result.data.size());
 
+  if (!result.success) {
+    return result;
+  }
+
+  result.unoptimized = internal::GetSpirvStats(result.data);
+  if (!options.optimizer_passes.empty() &&
+      !internal::OptimizeSpirv(options.optimizer_passes, result)) {
+    return result;
+  }
+  result.optimized = internal::GetSpirvStats(result.data);
+
+  if (!options.optimizer_passes.empty()) {
+    log::Debug(
+        "Shader {} optimized in {} us: {} -> {} bytes, {} -> {} instructions",
+        filename,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            result.optimization_time)
+            .count(),
+        result.unoptimized.size, result.optimized.size,
+        result.unoptimized.instruction_count,
+        result.optimized.instruction_count);
+  }
+
+  result.reflection = internal::ReflectShader(result.data, type);
+
+  if (cache_ != nullptr) {
+    cache_->Store(cache_key, {.data = result.data,
+                              .includes = result.includes,
+                              .reflection = result.reflection,
+                              .unoptimized = result.unoptimized,
+                              .optimized = result.optimized});
+  }
+
   return result;
 }
 
+auto ShaderCompiler::IsCacheValid(
+    const ShaderCacheEntry& entry,
+    std::span<const std::string> include_directories) const -> bool {
+  // The includes are resolved again, so a new file that shadows an include
+  // is detected, and the included files are read again, their hashes must
+  // match.
+  if (entry.includes.empty()) {
+    return true;
+  }
+
+  if (include_storage_ == nullptr) {
+    return false;
+  }
+
+  for (const auto& include : entry.includes) {
+    auto path = internal::ShaderIncluder::Resolve(
+        *include_storage_, include_directories, include.requested,
+        include.relative ? shaderc_include_type_relative
+                         : shaderc_include_type_standard,
+        include.included_by);
+    if (path != include.path) {
+      return false;
+    }
+
+    // A file removed or unreadable since the storage was indexed is a miss,
+    // the compilation reports the error.
+    try {
+      auto file = include_storage_->GetFile(path, storage::FileMode::kStream);
+      file.Open();
+      if (storage::HashContent(file.ReadAll()) != include.hash) {
+        return false;
+      }
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+auto ShaderCompiler::Reflect(std::span<const uint8_t> data, ShaderStage type)
+    -> ShaderReflection {
+  return internal::ReflectShader(data, type);
+}
+
+auto ShaderCompiler::CompileBatch(std::span<const CompileShaderJob> jobs)
+    -> std::vector<CompileShaderResult> {
+  CHR_ZONE_SCOPED();
+
+  utils::ThreadPool* thread_pool = nullptr;
+  {
+    std::lock_guard lock{thread_pool_mutex_};
+    if (thread_pool_ == nullptr) {
+      thread_pool_ = std::make_unique<utils::ThreadPool>();
+    }
+    thread_pool = thread_pool_.get();
+  }
+
+  std::vector<std::future<CompileShaderResult>> futures{};
+  futures.reserve(jobs.size());
+  for (const auto& job : jobs) {
+    futures.push_back(thread_pool->Submit([this, &job] {
+      return Compile(job.source, job.filename, job.type, job.options);
+    }));
+  }
+
+  // The tasks read the jobs of the caller, so all of them are waited for
+  // before an exception is rethrown.
+  std::vector<CompileShaderResult> results{};
+  results.reserve(jobs.size());
+  std::exception_ptr exception{};
+  for (auto& future : futures) {
+    try {
+      results.push_back(future.get());
+    } catch (...) {
+      if (exception == nullptr) {
+        exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception != nullptr) {
+    std::rethrow_exception(exception);
+  }
+
+  return results;
+}
+
 }  // namespace chr::renderer
\ No newline at end of file
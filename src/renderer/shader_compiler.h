@@ -5,7 +5,14 @@
 #ifndef CHR_RENDERER_SHADER_COMPILER_H_
 #define CHR_RENDERER_SHADER_COMPILER_H_
 
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <span>
+
 #include "pch.h"
+#include "shader_cache.h"
+#include "shader_reflection.h"
 
 namespace chr::renderer {
 
@@ -34,6 +41,23 @@ struct CompileSharerOptions {
 
   //! @brief Treats all compiler warnings as errors.
   bool warning_as_errors{false};
+
+  //! @brief Directories of the include storage searched for the included
+  //!        files, see ShaderCompiler::SetIncludeStorage. The files included
+  //!        with quotes are searched next to the including file first.
+  std::vector<std::string> include_directories{};
+
+  //! @brief Preprocessor macros defined before the source, by name. An
+  //!        empty value defines the macro without a value.
+  std::map<std::string, std::string, std::less<>> definitions{};
+
+  //! @brief Passes of the spirv-tools optimizer run after the compilation,
+  //!        in order, as spirv-opt flags. The presets are "-O" (performance),
+  //!        "-Os" (size) and "--legalize-hlsl", single passes are for example
+  //!        "--eliminate-dead-code-aggressive", "--strip-debug" and
+  //!        "--strip-reflect". The optimizer is disabled when it's empty.
+  //!        The reflection names are empty when the debug info is stripped.
+  std::vector<std::string> optimizer_passes{};
 };
 
 //! @brief Result object for shader compile that contain the compiler output and
@@ -42,6 +66,10 @@ struct CompileShaderResult {
   //! @brief It's true if the shader is compiled correctly.
   bool success{false};
 
+  //! @brief It's true if the shader is read from the cache instead of being
+  //!        compiled, see ShaderCompiler::SetCache.
+  bool cached{false};
+
   //! @brief Compiler error messages.
   std::vector<std::string> errors{};
 
@@ -53,20 +81,122 @@ struct CompileShaderResult {
 
   //! @brief Shader compiled binary data.
   std::vector<uint8_t> data{};
+
+  //! @brief Files included by the shader, directly or by other included
+  //!        files, one for every resolved #include directive. Together they
+  //!        form the include graph of the shader.
+  std::vector<ShaderInclude> includes{};
+
+  //! @brief SPIR-V generated by the compiler, before the optimizer passes
+  //!        (see CompileSharerOptions::optimizer_passes).
+  SpirvStats unoptimized{};
+
+  //! @brief SPIR-V of the shader, after the optimizer passes.
+  SpirvStats optimized{};
+
+  //! @brief Time spent in the optimizer passes.
+  std::chrono::nanoseconds optimization_time{0};
+
+  //! @brief Interface of the compiled shader, pass it to
+  //!        DeviceI::CreateShader to let the device build the pipeline
+  //!        layouts.
+  ShaderReflection reflection{};
+};
+
+//! @brief Shader to compile in a batch, see ShaderCompiler::CompileBatch.
+struct CompileShaderJob {
+  //! @brief Shader source file data, it must be valid until the batch is
+  //!        completed.
+  std::span<const uint8_t> source{};
+
+  //! @brief Shader source file name, used for logging.
+  std::string filename{};
+
+  //! @brief Type of the shader to compile (vertex/fragment/etc.).
+  ShaderStage type{};
+
+  //! @brief Options for the shader compiler.
+  CompileSharerOptions options{};
 };
 
 //! @brief Compiler for shader files.
 struct ShaderCompiler {
-  //! @brief Compile a shader file into binary format.
+  //! @brief Keep the compiled shaders in a persistent cache. The successfully
+  //!        compiled shaders are stored in the cache, the next compilations
+  //!        of the same source with the same options read them back from it
+  //!        (the compiler messages are not cached).
+  //! @param cache Cache to use, or nullptr to disable it.
+  auto SetCache(std::shared_ptr<ShaderCache> cache) -> void {
+    cache_ = std::move(cache);
+  }
+
+  //! @brief Resolve the #include directives of the shaders with the files
+  //!        of a storage. The file name passed to Compile is the storage path
+  //!        of the shader, it's used to find the files included with quotes.
+  //!        The included files are listed in the compilation result, the
+  //!        cached shaders are compiled again when one of them changes.
+  //! @param storage Storage of the included files, it must outlive the
+  //!                compiler. Use nullptr to disable the includes.
+  auto SetIncludeStorage(const storage::Storage* storage) -> void {
+    include_storage_ = storage;
+  }
+
+  //! @brief Get the key of a shader in the cache. It depends on the source,
+  //!        the directory of the shader, the stage, the options and the
+  //!        version of the compiler, so the key changes when any of them
+  //!        changes. The included files are checked when the shader is
+  //!        found in the cache.
   //! @param source Shader source file data.
+  //! @param filename Shader source file name.
+  //! @param type Type of the shader to compile (vertex/fragment/etc.).
+  //! @param options Options for the shader compiler.
+  //! @return Cache key.
+  static auto GetCacheKey(std::span<const uint8_t> source,
+                          std::string_view filename, ShaderStage type,
+                          const CompileSharerOptions& options)
+      -> ShaderCacheKey;
+
+  //! @brief Compile a shader file into binary format.
+  //! @param source Shader source file data. It's only read during the call,
+  //!               so it can point directly to a mapped file (see
+  //!               storage::File::Map) or to memory owned by the caller.
   //! @param filename Shader source file name. It's used for logging and doesn't
   //!                 necessarily have to be a 'file name'.
   //! @param type Type of the shader to compile (vertex/fragment/etc.).
   //! @param options Additional options (optional) for tune shader compiler.
   //! @return Compilation result.
-  auto Compile(std::vector<uint8_t> source, const std::string& filename,
+  auto Compile(std::span<const uint8_t> source, const std::string& filename,
                ShaderStage type, CompileSharerOptions options = {}) const
       -> CompileShaderResult;
+
+  //! @brief Read the interface of a compiled shader. Compile already returns
+  //!        it, this is for the shaders compiled elsewhere (ex. baked at
+  //!        build time, see BakedShaders).
+  //! @param data Shader binary data.
+  //! @param type Type of the shader (vertex/fragment/etc.).
+  //! @return Shader reflection.
+  static auto Reflect(std::span<const uint8_t> data, ShaderStage type)
+      -> ShaderReflection;
+
+  //! @brief Compile many shaders concurrently on a pool of worker threads,
+  //!        one for each hardware thread. Every worker reuses the same
+  //!        compiler instance for all its shaders. The pool is created on
+  //!        the first call and kept for the next batches, it's safe to call
+  //!        from many threads.
+  //! @param jobs Shaders to compile.
+  //! @return Compilation results, in the same order of the jobs.
+  auto CompileBatch(std::span<const CompileShaderJob> jobs)
+      -> std::vector<CompileShaderResult>;
+
+ private:
+  auto IsCacheValid(const ShaderCacheEntry& entry,
+                    std::span<const std::string> include_directories) const
+      -> bool;
+
+  std::shared_ptr<ShaderCache> cache_{};
+  const storage::Storage* include_storage_{nullptr};
+  std::mutex thread_pool_mutex_{};
+  std::unique_ptr<utils::ThreadPool> thread_pool_{};
 };
 
 }  // namespace chr::renderer
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_dependencies.h"
+
+namespace chr::renderer {
+
+auto ShaderDependencies::SetIncludes(std::string_view shader,
+                                     std::span<const ShaderInclude> includes)
+    -> void {
+  Remove(shader);
+
+  // The includes of a compilation result already cover the nested includes,
+  // so every included file points straight to the shader.
+  auto shader_path = storage::NormalizePath(shader);
+  auto& paths = includes_[shader_path];
+  for (const auto& include : includes) {
+    if (dependents_[include.path].insert(shader_path).second) {
+      paths.push_back(include.path);
+    }
+  }
+}
+
+auto ShaderDependencies::Remove(std::string_view shader) -> void {
+  auto it = includes_.find(storage::NormalizePath(shader));
+  if (it == includes_.end()) {
+    return;
+  }
+
+  for (const auto& path : it->second) {
+    auto dependents = dependents_.find(path);
+    dependents->second.erase(it->first);
+    if (dependents->second.empty()) {
+      dependents_.erase(dependents);
+    }
+  }
+
+  includes_.erase(it);
+}
+
+auto ShaderDependencies::GetDependents(std::string_view path) const
+    -> std::vector<std::string> {
+  auto normalized = storage::NormalizePath(path);
+
+  std::set<std::string> shaders{};
+  if (auto it = dependents_.find(normalized); it != dependents_.end()) {
+    shaders = it->second;
+  }
+
+  if (includes_.contains(normalized)) {
+    shaders.insert(std::move(normalized));
+  }
+
+  return {shaders.begin(), shaders.end()};
+}
+
+}  // namespace chr::renderer
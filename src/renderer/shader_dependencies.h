@@ -0,0 +1,48 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_SHADER_DEPENDENCIES_H_
+#define CHR_RENDERER_SHADER_DEPENDENCIES_H_
+
+#include <set>
+#include <span>
+#include <unordered_map>
+
+#include "pch.h"
+#include "shader_cache.h"
+
+namespace chr::renderer {
+
+//! @brief Files included by a set of shaders, built from the includes of
+//!        the compilation results (see CompileShaderResult::includes). When
+//!        a file changes only the shaders that include it need to be
+//!        compiled again.
+struct ShaderDependencies {
+  //! @brief Set the files included by a shader, the previous ones are
+  //!        replaced.
+  //! @param shader Storage path of the shader.
+  //! @param includes Files included by the shader.
+  auto SetIncludes(std::string_view shader,
+                   std::span<const ShaderInclude> includes) -> void;
+
+  //! @brief Forget a shader.
+  //! @param shader Storage path of the shader.
+  auto Remove(std::string_view shader) -> void;
+
+  //! @brief Get the shaders affected by a changed file: the shaders that
+  //!        include it, directly or through other included files, and the
+  //!        file itself if it's a known shader.
+  //! @param path Storage path of the changed file.
+  //! @return Storage paths of the shaders, sorted.
+  [[nodiscard]] auto GetDependents(std::string_view path) const
+      -> std::vector<std::string>;
+
+ private:
+  std::unordered_map<std::string, std::vector<std::string>> includes_{};
+  std::unordered_map<std::string, std::set<std::string>> dependents_{};
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_SHADER_DEPENDENCIES_H_
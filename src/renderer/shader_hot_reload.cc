@@ -0,0 +1,201 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_hot_reload.h"
+
+#include <set>
+
+namespace chr::renderer {
+
+ShaderHotReload::ShaderHotReload(Device device, storage::Storage& storage,
+                                 const ShaderCompiler& compiler,
+                                 uint32_t frames_in_flight)
+    : device_{std::move(device)},
+      storage_{storage},
+      compiler_{compiler},
+      frames_in_flight_{frames_in_flight},
+      thread_pool_{std::make_unique<utils::ThreadPool>(1)} {
+  storage_.Watch();
+}
+
+ShaderHotReload::~ShaderHotReload() {
+  if (pending_reload_.valid()) {
+    pending_reload_.wait();
+  }
+}
+
+auto ShaderHotReload::AddPipeline(HotReloadPipelineInfo info)
+    -> HotReloadPipelineId {
+  CHR_ZONE_SCOPED();
+
+  ReloadResult result{};
+  auto pipeline = CreatePipeline(info, result);
+  if (pipeline == nullptr) {
+    throw RendererException(Error::kInvalidShader,
+                            "Failed to compile the shaders of the pipeline");
+  }
+
+  for (const auto& [path, includes] : result.includes) {
+    dependencies_.SetIncludes(path, includes);
+  }
+
+  pipelines_.push_back({.info = std::move(info), .pipeline = pipeline});
+  return pipelines_.size() - 1;
+}
+
+auto ShaderHotReload::Update() -> bool {
+  CHR_ZONE_SCOPED();
+
+  ++frame_;
+
+  // A pipeline retired in a frame is used at most by the previous frames in
+  // flight, they are completed frames_in_flight frames later.
+  while (!retired_pipelines_.empty() &&
+         retired_pipelines_.front().frame + frames_in_flight_ <= frame_) {
+    retired_pipelines_.pop_front();
+  }
+
+  auto swapped = false;
+  if (pending_reload_.valid()) {
+    if (pending_reload_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return false;
+    }
+    swapped = FinishReload();
+  }
+
+  StartReload();
+
+  return swapped;
+}
+
+auto ShaderHotReload::GetStats() const -> ShaderHotReloadStats {
+  auto stats = stats_;
+  stats.retired_pipelines = retired_pipelines_.size();
+  return stats;
+}
+
+auto ShaderHotReload::CreatePipeline(const HotReloadPipelineInfo& info,
+                                     ReloadResult& result) const
+    -> Pipeline {
+  auto create_info = info.info;
+  create_info.shader_set.clear();
+
+  for (const auto& [stage, shader] : info.shaders) {
+    auto file = storage_.GetFile(shader.path, storage::FileMode::kStream);
+    file.Open();
+    auto compiled =
+        compiler_.Compile(file.ReadAll(), shader.path, stage, shader.options);
+    if (!compiled.success) {
+      log::Warn("Shader {} failed to compile, its pipelines are not reloaded",
+                shader.path);
+      return nullptr;
+    }
+
+    result.includes.emplace_back(shader.path, std::move(compiled.includes));
+    create_info.shader_set[stage] =
+        device_->CreateShader(compiled.data, compiled.reflection);
+  }
+
+  return device_->CreatePipeline(info.render_pass, create_info);
+}
+
+auto ShaderHotReload::StartReload() -> void {
+  // The storage is read by the background thread, it's polled only when no
+  // reload is running.
+  auto changes = storage_.PollChanges();
+  if (changes.empty()) {
+    return;
+  }
+
+  // The root path is reported when the changes are lost, everything is
+  // reloaded.
+  auto reload_all = false;
+  std::set<std::string> shaders{};
+  for (const auto& change : changes) {
+    if (change.path == "/") {
+      reload_all = true;
+      break;
+    }
+
+    for (auto& shader : dependencies_.GetDependents(change.path)) {
+      shaders.insert(std::move(shader));
+    }
+  }
+
+  std::vector<std::pair<HotReloadPipelineId, HotReloadPipelineInfo>>
+      affected{};
+  for (HotReloadPipelineId id = 0; id < pipelines_.size(); ++id) {
+    const auto& info = pipelines_[id].info;
+    if (reload_all ||
+        std::ranges::any_of(info.shaders, [&shaders](const auto& shader) {
+          return shaders.contains(storage::NormalizePath(shader.second.path));
+        })) {
+      affected.emplace_back(id, info);
+    }
+  }
+
+  if (affected.empty()) {
+    return;
+  }
+
+  log::Info("Reloading {} pipelines", affected.size());
+
+  pending_reload_ =
+      thread_pool_->Submit([this, affected = std::move(affected)] {
+        CHR_ZONE_SCOPED();
+
+        auto start = std::chrono::steady_clock::now();
+
+        // A pipeline that fails keeps the previous version.
+        ReloadResult result{};
+        for (const auto& [id, info] : affected) {
+          try {
+            if (auto pipeline = CreatePipeline(info, result);
+                pipeline != nullptr) {
+              result.pipelines.emplace_back(id, std::move(pipeline));
+            } else {
+              ++result.failed_pipelines;
+            }
+          } catch (const std::exception& e) {
+            log::Err("Failed to reload a pipeline: {}", e.what());
+            ++result.failed_pipelines;
+          }
+        }
+
+        result.time = std::chrono::steady_clock::now() - start;
+        return result;
+      });
+}
+
+auto ShaderHotReload::FinishReload() -> bool {
+  auto result = pending_reload_.get();
+
+  for (const auto& [path, includes] : result.includes) {
+    dependencies_.SetIncludes(path, includes);
+  }
+
+  // The swapped pipelines may still be used by the frames in flight.
+  for (auto& [id, pipeline] : result.pipelines) {
+    auto& current = pipelines_[id].pipeline;
+    retired_pipelines_.push_back(
+        {.pipeline = std::exchange(current, std::move(pipeline)),
+         .frame = frame_});
+  }
+
+  stats_.reloads++;
+  stats_.swapped_pipelines += result.pipelines.size();
+  stats_.failed_pipelines += result.failed_pipelines;
+  stats_.last_reload_time = result.time;
+
+  log::Info("{} pipelines reloaded in {} ms, {} failed",
+            result.pipelines.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(result.time)
+                .count(),
+            result.failed_pipelines);
+
+  return !result.pipelines.empty();
+}
+
+}  // namespace chr::renderer
\ No newline at end of file
@@ -0,0 +1,172 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_SHADER_HOT_RELOAD_H_
+#define CHR_RENDERER_SHADER_HOT_RELOAD_H_
+
+#include <chrono>
+#include <deque>
+#include <future>
+
+#include "device.h"
+#include "pch.h"
+#include "shader_compiler.h"
+#include "shader_dependencies.h"
+
+namespace chr::renderer {
+
+//! @brief Shader of a hot reloaded pipeline.
+struct HotReloadShader {
+  //! @brief Storage path of the shader source.
+  std::string path{};
+
+  //! @brief Options for the shader compiler.
+  CompileSharerOptions options{};
+};
+
+//! @brief Informations used to create a hot reloaded pipeline.
+struct HotReloadPipelineInfo {
+  //! @brief Render pass used to create the pipeline.
+  RenderPass render_pass{};
+
+  //! @brief Shaders of the pipeline, compiled from their sources.
+  std::unordered_map<ShaderStage, HotReloadShader> shaders{};
+
+  //! @brief Informations used to create the pipeline, the shader set is
+  //!        filled with the compiled shaders.
+  PipelineCreateInfo info{};
+};
+
+//! @brief Identifier of a hot reloaded pipeline.
+using HotReloadPipelineId = size_t;
+
+//! @brief Statistics about the hot reload of the shaders.
+struct ShaderHotReloadStats {
+  //! @brief Reloads completed, every reload rebuilds all the pipelines
+  //!        affected by a set of changes.
+  uint64_t reloads{0};
+
+  //! @brief Pipelines rebuilt and swapped.
+  uint64_t swapped_pipelines{0};
+
+  //! @brief Pipelines that failed to rebuild, they keep the previous shaders.
+  uint64_t failed_pipelines{0};
+
+  //! @brief Pipelines swapped out and not destroyed yet.
+  uint64_t retired_pipelines{0};
+
+  //! @brief Duration of the last reload, on the background thread.
+  std::chrono::nanoseconds last_reload_time{0};
+};
+
+//! @brief Rebuild the pipelines when the sources of their shaders change.
+//!        The storage is watched for changes (see storage::Storage::Watch),
+//!        the affected shaders, found through their includes, are compiled
+//!        on a background thread and their pipelines are created there too.
+//!        The new pipelines replace the old ones in Update, at a frame
+//!        boundary, and the old ones are destroyed when the frames in
+//!        flight that may use them are completed. The frame never waits for
+//!        the compiler.
+//!        The compiler should resolve the includes with the same storage
+//!        (see ShaderCompiler::SetIncludeStorage), so the changes of the
+//!        included files reload the shaders too.
+struct ShaderHotReload {
+  //! @brief Start watching the storage.
+  //! @param device Device used to create the shaders and the pipelines.
+  //! @param storage Storage of the shader sources, it must outlive the
+  //!                service. It's read by the background thread, while a
+  //!                reload is running the service doesn't poll it.
+  //! @param compiler Compiler of the shaders, it must outlive the service.
+  //! @param frames_in_flight Number of frames that the device may be
+  //!                         processing while the next one is recorded.
+  //! @exception std::system_error The storage can't be watched.
+  explicit ShaderHotReload(Device device, storage::Storage& storage,
+                           const ShaderCompiler& compiler,
+                           uint32_t frames_in_flight);
+
+  //! @brief The copy constructor is not supported.
+  ShaderHotReload(const ShaderHotReload&) = delete;
+
+  //! @brief The move constructor is not supported.
+  ShaderHotReload(ShaderHotReload&&) noexcept = delete;
+
+  //! @brief Wait for the running reload and destroy the pipelines. The device
+  //!        must be idle.
+  ~ShaderHotReload();
+
+  //! @brief The copy assignment operator is not supported.
+  ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  ShaderHotReload& operator=(ShaderHotReload&&) noexcept = delete;
+
+  //! @brief Compile the shaders and create a pipeline, on the calling
+  //!        thread.
+  //! @param info Informations used to create the pipeline.
+  //! @return Pipeline identifier.
+  //! @exception RendererException A shader failed to compile.
+  auto AddPipeline(HotReloadPipelineInfo info) -> HotReloadPipelineId;
+
+  //! @brief Get the current version of a pipeline, it can change in Update.
+  //! @param id Pipeline identifier.
+  //! @return Pipeline.
+  [[nodiscard]] auto GetPipeline(HotReloadPipelineId id) const
+      -> const Pipeline& {
+    return pipelines_.at(id).pipeline;
+  }
+
+  //! @brief Swap in the pipelines rebuilt in background, destroy the
+  //!        retired ones that are no longer in use and start a new reload
+  //!        if some shaders changed. It must be called once per frame, after
+  //!        waiting for the frame fence and before recording the commands.
+  //! @return True if some pipelines have been swapped, the command buffers
+  //!         recorded with the previous pipelines must be recorded again.
+  auto Update() -> bool;
+
+  //! @brief Get the statistics about the reloads.
+  //! @return Reload statistics.
+  [[nodiscard]] auto GetStats() const -> ShaderHotReloadStats;
+
+ private:
+  struct PipelineEntry {
+    HotReloadPipelineInfo info{};
+    Pipeline pipeline{};
+  };
+
+  struct RetiredPipeline {
+    Pipeline pipeline{};
+    uint64_t frame{0};
+  };
+
+  struct ReloadResult {
+    std::vector<std::pair<HotReloadPipelineId, Pipeline>> pipelines{};
+    std::vector<std::pair<std::string, std::vector<ShaderInclude>>>
+        includes{};
+    uint64_t failed_pipelines{0};
+    std::chrono::nanoseconds time{0};
+  };
+
+  auto CreatePipeline(const HotReloadPipelineInfo& info,
+                      ReloadResult& result) const -> Pipeline;
+  auto StartReload() -> void;
+  auto FinishReload() -> bool;
+
+  Device device_;
+  storage::Storage& storage_;
+  const ShaderCompiler& compiler_;
+  uint32_t frames_in_flight_;
+
+  std::vector<PipelineEntry> pipelines_{};
+  std::deque<RetiredPipeline> retired_pipelines_{};
+  ShaderDependencies dependencies_{};
+  ShaderHotReloadStats stats_{};
+  uint64_t frame_{0};
+
+  std::future<ReloadResult> pending_reload_{};
+  std::unique_ptr<utils::ThreadPool> thread_pool_{};
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_SHADER_HOT_RELOAD_H_
\ No newline at end of file
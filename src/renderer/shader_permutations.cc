@@ -0,0 +1,134 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "shader_permutations.h"
+
+namespace chr::renderer {
+
+ShaderPermutations::ShaderPermutations(ShaderCompiler& compiler,
+                                       std::vector<uint8_t> source,
+                                       std::string filename, ShaderStage type,
+                                       std::vector<std::string> defines,
+                                       CompileSharerOptions options)
+    : compiler_{compiler},
+      source_{std::move(source)},
+      filename_{std::move(filename)},
+      type_{type},
+      defines_{std::move(defines)},
+      options_{std::move(options)} {
+  if (defines_.size() > kMaxShaderDefines) {
+    throw std::invalid_argument(
+        fmt::format("Shader {} has {} defines, the limit is {}", filename_,
+                    defines_.size(), kMaxShaderDefines));
+  }
+
+  stats_.define_count = defines_.size();
+}
+
+auto ShaderPermutations::GetKey(std::span<const std::string_view> defines) const
+    -> ShaderVariantKey {
+  ShaderVariantKey key{};
+  for (const auto& define : defines) {
+    auto it = std::ranges::find(defines_, define);
+    if (it == defines_.end()) {
+      throw std::invalid_argument(
+          fmt::format("Shader {} has no define {}", filename_, define));
+    }
+    key.set(it - defines_.begin());
+  }
+  return key;
+}
+
+auto ShaderPermutations::Get(const ShaderVariantKey& key)
+    -> const CompileShaderResult& {
+  ValidateKey(key);
+  if (auto it = variants_.find(key); it != variants_.end()) {
+    return it->second;
+  }
+
+  CHR_ZONE_SCOPED();
+
+  auto start = std::chrono::steady_clock::now();
+  auto result = compiler_.Compile(source_, filename_, type_, GetOptions(key));
+  return AddVariant(key, std::move(result),
+                    std::chrono::steady_clock::now() - start);
+}
+
+auto ShaderPermutations::Precompile(std::span<const ShaderVariantKey> keys)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  for (const auto& key : keys) {
+    ValidateKey(key);
+  }
+
+  std::vector<ShaderVariantKey> pending_keys{};
+  std::vector<CompileShaderJob> jobs{};
+  for (const auto& key : keys) {
+    if (!variants_.contains(key) &&
+        std::ranges::find(pending_keys, key) == pending_keys.end()) {
+      pending_keys.push_back(key);
+      jobs.push_back({.source = source_,
+                      .filename = filename_,
+                      .type = type_,
+                      .options = GetOptions(key)});
+    }
+  }
+
+  if (jobs.empty()) {
+    return;
+  }
+
+  // The jobs run concurrently, the time of the batch is split among them.
+  auto start = std::chrono::steady_clock::now();
+  auto results = compiler_.CompileBatch(jobs);
+  auto compile_time = (std::chrono::steady_clock::now() - start) /
+                      static_cast<int64_t>(jobs.size());
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    AddVariant(pending_keys[i], std::move(results[i]), compile_time);
+  }
+}
+
+auto ShaderPermutations::ValidateKey(const ShaderVariantKey& key) const
+    -> void {
+  // The bits past the defines would compile the same variant under another
+  // key.
+  if ((key >> defines_.size()).any()) {
+    throw std::invalid_argument(
+        fmt::format("Shader {} variant {:#x} enables a missing define",
+                    filename_, key.to_ullong()));
+  }
+}
+
+auto ShaderPermutations::GetOptions(const ShaderVariantKey& key) const
+    -> CompileSharerOptions {
+  auto options = options_;
+  for (size_t i = 0; i < defines_.size(); ++i) {
+    if (key.test(i)) {
+      options.definitions.insert_or_assign(defines_[i], "1");
+    }
+  }
+  return options;
+}
+
+auto ShaderPermutations::AddVariant(const ShaderVariantKey& key,
+                                    CompileShaderResult result,
+                                    std::chrono::nanoseconds compile_time)
+    -> const CompileShaderResult& {
+  ++stats_.variant_count;
+  stats_.cached_count += result.cached ? 1 : 0;
+  stats_.failed_count += result.success ? 0 : 1;
+  stats_.compile_time += compile_time;
+
+  log::Debug("Shader {} variant {:#x} {} in {} us", filename_, key.to_ullong(),
+             result.cached ? "loaded" : "compiled",
+             std::chrono::duration_cast<std::chrono::microseconds>(compile_time)
+                 .count());
+  CHR_PLOT("Shader variants", static_cast<int64_t>(stats_.variant_count));
+
+  return variants_.emplace(key, std::move(result)).first->second;
+}
+
+}  // namespace chr::renderer
\ No newline at end of file
@@ -0,0 +1,130 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_SHADER_PERMUTATIONS_H_
+#define CHR_RENDERER_SHADER_PERMUTATIONS_H_
+
+#include <bitset>
+#include <chrono>
+
+#include "pch.h"
+#include "shader_compiler.h"
+
+namespace chr::renderer {
+
+//! @brief Maximum number of defines of a shader permutation set.
+constexpr size_t kMaxShaderDefines = 64;
+
+//! @brief Key of a shader variant, the bit i enables the i-th define of the
+//!        permutation set.
+using ShaderVariantKey = std::bitset<kMaxShaderDefines>;
+
+//! @brief Statistics about the variants of a shader.
+struct ShaderPermutationStats {
+  //! @brief Number of defines of the permutation set.
+  size_t define_count{0};
+
+  //! @brief Variants requested so far, compiled or read from the cache.
+  size_t variant_count{0};
+
+  //! @brief Variants read from the compiler cache.
+  size_t cached_count{0};
+
+  //! @brief Variants that failed to compile.
+  size_t failed_count{0};
+
+  //! @brief Time spent compiling the variants, including the cache lookups.
+  std::chrono::nanoseconds compile_time{0};
+};
+
+//! @brief Variants of a shader built by enabling a subset of its defines.
+//!        The enabled defines are passed to the compiler as macros with the
+//!        value 1, the others are not defined. Every variant is a separate
+//!        compilation, so the defines are meant for code that changes the
+//!        shader interface or structure (ex. skinning). The values that only
+//!        change constants are better declared as specialization constants
+//!        and set with PipelineCreateInfo::specialization_constants, which
+//!        reuses the same compiled shader.
+//!        The variants are compiled on the first request or ahead of time
+//!        with Precompile. The compiler cache (see ShaderCompiler::SetCache)
+//!        keeps them between runs.
+struct ShaderPermutations {
+  //! @brief Create a permutation set.
+  //! @param compiler Compiler of the variants, it must outlive the set.
+  //! @param source Shader source file data.
+  //! @param filename Shader source file name.
+  //! @param type Type of the shader (vertex/fragment/etc.).
+  //! @param defines Names of the defines, at most kMaxShaderDefines.
+  //! @param options Options shared by all the variants.
+  explicit ShaderPermutations(ShaderCompiler& compiler,
+                              std::vector<uint8_t> source,
+                              std::string filename, ShaderStage type,
+                              std::vector<std::string> defines,
+                              CompileSharerOptions options = {});
+
+  //! @brief The copy constructor is not supported.
+  ShaderPermutations(const ShaderPermutations&) = delete;
+
+  //! @brief The move constructor is not supported.
+  ShaderPermutations(ShaderPermutations&&) noexcept = delete;
+
+  ~ShaderPermutations() = default;
+
+  //! @brief The copy assignment operator is not supported.
+  ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  ShaderPermutations& operator=(ShaderPermutations&&) noexcept = delete;
+
+  //! @brief Get the key of the variant that enables some defines.
+  //! @param defines Names of the enabled defines.
+  //! @return Variant key.
+  //! @exception std::invalid_argument A define is not in the set.
+  [[nodiscard]] auto GetKey(std::span<const std::string_view> defines) const
+      -> ShaderVariantKey;
+
+  //! @brief Get a variant, it's compiled if it's requested for the first
+  //!        time.
+  //! @param key Variant key.
+  //! @return Compilation result of the variant, valid until the set is
+  //!         destroyed.
+  //! @exception std::invalid_argument The key enables a define that is not
+  //!            in the set.
+  auto Get(const ShaderVariantKey& key) -> const CompileShaderResult&;
+
+  //! @brief Compile many variants ahead of time, concurrently (see
+  //!        ShaderCompiler::CompileBatch). The variants already compiled are
+  //!        skipped.
+  //! @param keys Variant keys.
+  //! @exception std::invalid_argument A key enables a define that is not in
+  //!            the set.
+  auto Precompile(std::span<const ShaderVariantKey> keys) -> void;
+
+  //! @brief Get the statistics about the variants.
+  //! @return Variant statistics.
+  [[nodiscard]] auto GetStats() const -> ShaderPermutationStats {
+    return stats_;
+  }
+
+ private:
+  auto ValidateKey(const ShaderVariantKey& key) const -> void;
+  auto GetOptions(const ShaderVariantKey& key) const -> CompileSharerOptions;
+  auto AddVariant(const ShaderVariantKey& key, CompileShaderResult result,
+                  std::chrono::nanoseconds compile_time)
+      -> const CompileShaderResult&;
+
+  ShaderCompiler& compiler_;
+  std::vector<uint8_t> source_;
+  std::string filename_;
+  ShaderStage type_;
+  std::vector<std::string> defines_;
+  CompileSharerOptions options_;
+
+  std::unordered_map<ShaderVariantKey, CompileShaderResult> variants_{};
+  ShaderPermutationStats stats_{};
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_SHADER_PERMUTATIONS_H_
\ No newline at end of file
@@ -0,0 +1,93 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_SHADER_REFLECTION_H_
+#define CHR_RENDERER_SHADER_REFLECTION_H_
+
+#include "enums.h"
+#include "pch.h"
+
+namespace chr::renderer {
+
+//! @brief Resource accessed by a shader through a descriptor.
+struct DescriptorBinding {
+  //! @brief Descriptor set of the resource.
+  uint32_t set{0};
+
+  //! @brief Binding of the resource in the descriptor set.
+  uint32_t binding{0};
+
+  //! @brief Type of the resource.
+  DescriptorType type{DescriptorType::kUniformBuffer};
+
+  //! @brief Number of descriptors, greater than one for the arrays and zero
+  //!        for the arrays without a size (not supported by the pipeline
+  //!        layouts).
+  uint32_t count{1};
+
+  //! @brief Name of the resource in the shader source.
+  std::string name{};
+};
+
+//! @brief Range of the push constants accessed by a shader.
+struct PushConstantRange {
+  //! @brief Offset of the range in bytes.
+  uint32_t offset{0};
+
+  //! @brief Size of the range in bytes.
+  uint32_t size{0};
+};
+
+//! @brief Input attribute of a vertex shader.
+struct VertexInput {
+  //! @brief Location of the attribute.
+  uint32_t location{0};
+
+  //! @brief Format of the attribute.
+  Format format{Format::kUndefined};
+
+  //! @brief Size of the attribute in bytes.
+  uint32_t size{0};
+
+  //! @brief Name of the attribute in the shader source.
+  std::string name{};
+};
+
+//! @brief Specialization constant declared by a shader.
+struct SpecializationConstant {
+  //! @brief Constant id, as in layout(constant_id = ...).
+  uint32_t id{0};
+
+  //! @brief Size of the constant value in bytes.
+  uint32_t size{0};
+
+  //! @brief Type of the constant value, a SpecializationValue must hold the
+  //!        same type.
+  ScalarType type{ScalarType::kOther};
+
+  //! @brief Name of the constant in the shader source.
+  std::string name{};
+};
+
+//! @brief Interface of a compiled shader, read from its SPIR-V code. It's
+//!        used by the devices to build the pipeline layouts and the vertex
+//!        input state of the pipelines.
+struct ShaderReflection {
+  //! @brief Resources accessed through descriptors, sorted by set and
+  //!        binding.
+  std::vector<DescriptorBinding> bindings{};
+
+  //! @brief Push constants accessed by the shader.
+  std::vector<PushConstantRange> push_constants{};
+
+  //! @brief Input attributes of a vertex shader, sorted by location.
+  std::vector<VertexInput> vertex_inputs{};
+
+  //! @brief Specialization constants, sorted by id.
+  std::vector<SpecializationConstant> specialization_constants{};
+};
+
+}  // namespace chr::renderer
+
+#endif  // CHR_RENDERER_SHADER_REFLECTION_H_
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "vulkan_fence.h"
 #include "vulkan_frame_buffer.h"
 #include "vulkan_instance.h"
+#include "vulkan_layout_cache.h"
 #include "vulkan_pipeline.h"
 #include "vulkan_render_pass.h"
 #include "vulkan_semaphore.h"
@@ -35,11 +36,17 @@ VulkanDevice::VulkanDevice(const VulkanInstance &instance,
 
   PickPhysicalDevice();
   CreateLogicalDevice();
+
+  layout_cache_ = std::make_unique<VulkanLayoutCache>(device_);
 }
 
 VulkanDevice::~VulkanDevice() {
   CHR_ZONE_SCOPED_VULKAN();
 
+  // The layouts are shared by the pipelines, they are destroyed with the
+  // device.
+  layout_cache_.reset();
+
   if (device_ != VK_NULL_HANDLE) {
     vkDestroyDevice(device_, nullptr);
   }
@@ -70,9 +77,10 @@ auto VulkanDevice::GetPhysicalDevices() const -> std::vector<VkPhysicalDevice> {
   return devices;
 }
 
-auto VulkanDevice::CreateShader(const std::vector<uint8_t> &data) const
+auto VulkanDevice::CreateShader(std::span<const uint8_t> data,
+                                const ShaderReflection &reflection) const
     -> Shader {
-  return std::make_shared<VulkanShader>(*this, data);
+  return std::make_shared<VulkanShader>(*this, data, reflection);
 }
 
 auto VulkanDevice::Submit(const SubmitInfo &info, const Fence &fence) -> void {
@@ -27,6 +27,7 @@ struct SwapChainSupportDetails {
 };
 
 struct VulkanInstance;
+struct VulkanLayoutCache;
 struct VulkanSurface;
 
 struct VulkanDevice : DeviceI {
@@ -41,7 +42,9 @@ struct VulkanDevice : DeviceI {
   VulkanDevice &operator=(const VulkanDevice &) = delete;
   VulkanDevice &operator=(VulkanDevice &&other) = delete;
 
-  auto CreateShader(const std::vector<uint8_t> &data) const -> Shader override;
+  auto CreateShader(std::span<const uint8_t> data,
+                    const ShaderReflection &reflection) const
+      -> Shader override;
   auto CreateSwapChain(const Surface &surface,
                        const SwapChainCreateInfo &info) const
       -> SwapChain override;
@@ -77,6 +80,7 @@ struct VulkanDevice : DeviceI {
       -> SwapChainSupportDetails;
 
   auto GetNativeDevice() const -> VkDevice { return device_; }
+  auto GetLayoutCache() const -> VulkanLayoutCache & { return *layout_cache_; }
 
  private:
   auto PickPhysicalDevice() -> void;
@@ -95,6 +99,8 @@ struct VulkanDevice : DeviceI {
   VkQueue present_queue_{VK_NULL_HANDLE};
 
   std::vector<const char *> device_extensions_{};
+
+  std::unique_ptr<VulkanLayoutCache> layout_cache_{};
 };
 
 }  // namespace chr::renderer::internal
@@ -0,0 +1,168 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "vulkan_layout_cache.h"
+
+#include "common.h"
+#include "vulkan_utils.h"
+
+namespace chr::renderer::internal {
+
+VulkanLayoutCache::~VulkanLayoutCache() {
+  CHR_ZONE_SCOPED_VULKAN();
+
+  for (const auto &[key, pipeline_layout] : pipeline_layouts_) {
+    vkDestroyPipelineLayout(device_, pipeline_layout, nullptr);
+  }
+
+  for (const auto &[key, descriptor_set_layout] : descriptor_set_layouts_) {
+    vkDestroyDescriptorSetLayout(device_, descriptor_set_layout, nullptr);
+  }
+}
+
+auto VulkanLayoutCache::GetPipelineLayout(const ShaderSet &shader_set)
+    -> VkPipelineLayout {
+  CHR_ZONE_SCOPED_VULKAN();
+
+  // Bindings sorted by set and binding, and push constant ranges with the
+  // stages that use them.
+  std::map<std::pair<uint32_t, uint32_t>, VkDescriptorSetLayoutBinding>
+      bindings{};
+  std::map<std::pair<uint32_t, uint32_t>, VkShaderStageFlags>
+      push_constants{};
+
+  for (const auto &[stage, shader] : shader_set) {
+    auto stage_flags = GetShaderStageFlagBits(stage);
+    const auto &reflection = shader->GetReflection();
+
+    for (const auto &binding : reflection.bindings) {
+      // The arrays without a size need descriptor indexing, that the device
+      // doesn't enable.
+      if (binding.count == 0) {
+        throw RendererException(
+            Error::kInvalidShader,
+            fmt::format("Descriptor {} (set = {}, binding = {}) is an array "
+                        "without a size, it's not supported",
+                        binding.name, binding.set, binding.binding));
+      }
+
+      auto type = GetVulkanDescriptorType(binding.type);
+      auto [it, inserted] = bindings.try_emplace(
+          {binding.set, binding.binding},
+          VkDescriptorSetLayoutBinding{.binding = binding.binding,
+                                       .descriptorType = type,
+                                       .descriptorCount = binding.count,
+                                       .stageFlags = 0,
+                                       .pImmutableSamplers = nullptr});
+      if (!inserted && it->second.descriptorType != type) {
+        throw RendererException(
+            Error::kInvalidShader,
+            fmt::format("Descriptor {} (set = {}, binding = {}) has a "
+                        "different type in every stage",
+                        binding.name, binding.set, binding.binding));
+      }
+
+      it->second.descriptorCount =
+          std::max(it->second.descriptorCount, binding.count);
+      it->second.stageFlags |= stage_flags;
+    }
+
+    // A stage can be in one range only, its ranges are merged.
+    if (!reflection.push_constants.empty()) {
+      auto begin = std::numeric_limits<uint32_t>::max();
+      uint32_t end = 0;
+      for (const auto &range : reflection.push_constants) {
+        begin = std::min(begin, range.offset);
+        end = std::max(end, range.offset + range.size);
+      }
+      push_constants[{begin, end - begin}] |= stage_flags;
+    }
+  }
+
+  std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets{};
+  for (const auto &[key, binding] : bindings) {
+    // The unused sets in the middle have empty layouts.
+    if (sets.size() <= key.first) {
+      sets.resize(key.first + 1);
+    }
+    sets[key.first].push_back(binding);
+  }
+
+  std::scoped_lock lock(mutex_);
+
+  PipelineLayoutKey key{};
+  for (const auto &set_bindings : sets) {
+    key.first.push_back(GetDescriptorSetLayout(set_bindings));
+  }
+  for (const auto &[range, stage_flags] : push_constants) {
+    key.second.push_back({stage_flags, range.first, range.second});
+  }
+
+  if (auto it = pipeline_layouts_.find(key); it != pipeline_layouts_.end()) {
+    return it->second;
+  }
+
+  std::vector<VkPushConstantRange> push_constant_ranges{};
+  push_constant_ranges.reserve(key.second.size());
+  for (const auto &[stage_flags, offset, size] : key.second) {
+    push_constant_ranges.push_back(
+        {.stageFlags = stage_flags, .offset = offset, .size = size});
+  }
+
+  VkPipelineLayoutCreateInfo pipeline_layout_info{};
+  pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(key.first.size());
+  pipeline_layout_info.pSetLayouts = key.first.data();
+  pipeline_layout_info.pushConstantRangeCount =
+      static_cast<uint32_t>(push_constant_ranges.size());
+  pipeline_layout_info.pPushConstantRanges = push_constant_ranges.data();
+
+  VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+  if (auto result = vkCreatePipelineLayout(device_, &pipeline_layout_info,
+                                           nullptr, &pipeline_layout);
+      result != VK_SUCCESS) {
+    throw VulkanException(result, "Failed to create pipeline layout");
+  }
+
+  pipeline_layouts_.emplace(std::move(key), pipeline_layout);
+
+  log::Debug("Pipeline layout created ({} cached)", pipeline_layouts_.size());
+
+  return pipeline_layout;
+}
+
+auto VulkanLayoutCache::GetDescriptorSetLayout(
+    const std::vector<VkDescriptorSetLayoutBinding> &bindings)
+    -> VkDescriptorSetLayout {
+  DescriptorSetLayoutKey key{};
+  key.reserve(bindings.size());
+  for (const auto &binding : bindings) {
+    key.push_back({binding.binding,
+                   static_cast<uint32_t>(binding.descriptorType),
+                   binding.descriptorCount, binding.stageFlags});
+  }
+
+  if (auto it = descriptor_set_layouts_.find(key);
+      it != descriptor_set_layouts_.end()) {
+    return it->second;
+  }
+
+  VkDescriptorSetLayoutCreateInfo layout_info{};
+  layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+  layout_info.pBindings = bindings.data();
+
+  VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
+  if (auto result = vkCreateDescriptorSetLayout(device_, &layout_info, nullptr,
+                                                &descriptor_set_layout);
+      result != VK_SUCCESS) {
+    throw VulkanException(result, "Failed to create descriptor set layout");
+  }
+
+  descriptor_set_layouts_.emplace(std::move(key), descriptor_set_layout);
+
+  return descriptor_set_layout;
+}
+
+}  // namespace chr::renderer::internal
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_RENDERER_VULKAN_VULKAN_LAYOUT_CACHE_H_
+#define CHR_RENDERER_VULKAN_VULKAN_LAYOUT_CACHE_H_
+
+#include <map>
+#include <mutex>
+
+#include "pch.h"
+#include "shader.h"
+#include "vulkan_pch.h"
+
+namespace chr::renderer::internal {
+
+// Descriptor set layouts and pipeline layouts built from the reflection of
+// the shaders. The pipelines with the same interface share the same layouts,
+// they are destroyed with the cache.
+struct VulkanLayoutCache {
+  explicit VulkanLayoutCache(VkDevice device) : device_(device) {}
+
+  VulkanLayoutCache(const VulkanLayoutCache &) = delete;
+  VulkanLayoutCache(VulkanLayoutCache &&other) noexcept = delete;
+
+  ~VulkanLayoutCache();
+
+  VulkanLayoutCache &operator=(const VulkanLayoutCache &) = delete;
+  VulkanLayoutCache &operator=(VulkanLayoutCache &&other) = delete;
+
+  // Get the pipeline layout of a set of shaders. The resources and the push
+  // constants used by many stages are visible to all of them.
+  auto GetPipelineLayout(const ShaderSet &shader_set) -> VkPipelineLayout;
+
+ private:
+  // Binding, descriptor type, descriptor count and stage flags.
+  using DescriptorSetLayoutKey = std::vector<std::array<uint32_t, 4>>;
+
+  // Descriptor set layouts and push constant ranges (stage flags, offset and
+  // size).
+  using PipelineLayoutKey = std::pair<std::vector<VkDescriptorSetLayout>,
+                                      std::vector<std::array<uint32_t, 3>>>;
+
+  auto GetDescriptorSetLayout(
+      const std::vector<VkDescriptorSetLayoutBinding> &bindings)
+      -> VkDescriptorSetLayout;
+
+  VkDevice device_{VK_NULL_HANDLE};
+
+  std::mutex mutex_{};
+  std::map<DescriptorSetLayoutKey, VkDescriptorSetLayout>
+      descriptor_set_layouts_{};
+  std::map<PipelineLayoutKey, VkPipelineLayout> pipeline_layouts_{};
+};
+
+}  // namespace chr::renderer::internal
+
+#endif  // CHR_RENDERER_VULKAN_VULKAN_LAYOUT_CACHE_H_
\ No newline at end of file
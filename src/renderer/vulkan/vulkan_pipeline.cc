@@ -6,12 +6,75 @@
 
 #include "common.h"
 #include "vulkan_device.h"
+#include "vulkan_layout_cache.h"
 #include "vulkan_render_pass.h"
 #include "vulkan_shader.h"
 #include "vulkan_utils.h"
 
 namespace chr::renderer::internal {
 
+static auto GetSpecializationType(const SpecializationValue &value)
+    -> ScalarType {
+  return std::visit(
+      [](auto data) {
+        using Type = decltype(data);
+        if constexpr (std::is_same_v<Type, bool>) {
+          return ScalarType::kBool;
+        } else if constexpr (std::is_same_v<Type, int32_t>) {
+          return ScalarType::kInt;
+        } else if constexpr (std::is_same_v<Type, uint32_t>) {
+          return ScalarType::kUInt;
+        } else {
+          return ScalarType::kFloat;
+        }
+      },
+      value);
+}
+
+static auto GetSpecializationData(const SpecializationValue &value)
+    -> uint32_t {
+  return std::visit(
+      [](auto data) -> uint32_t {
+        if constexpr (std::is_same_v<decltype(data), bool>) {
+          return data ? VK_TRUE : VK_FALSE;
+        } else {
+          return std::bit_cast<uint32_t>(data);
+        }
+      },
+      value);
+}
+
+static auto ValidateVertexLayout(const PipelineCreateInfo &info) -> void {
+  const auto &layout = info.vertex_layout;
+  for (const auto &attribute : layout.attributes) {
+    if (std::ranges::none_of(layout.buffers, [&attribute](const auto &buffer) {
+          return buffer.binding == attribute.binding;
+        })) {
+      throw RendererException(
+          Error::kInvalidShader,
+          fmt::format("Vertex attribute {} reads the missing binding {}",
+                      attribute.location, attribute.binding));
+    }
+  }
+
+  auto it = info.shader_set.find(ShaderStage::kVertex);
+  if (it == info.shader_set.end()) {
+    return;
+  }
+
+  for (const auto &input : it->second->GetReflection().vertex_inputs) {
+    if (std::ranges::none_of(layout.attributes, [&input](const auto &attr) {
+          return attr.location == input.location;
+        })) {
+      throw RendererException(
+          Error::kInvalidShader,
+          fmt::format("Vertex input {} at location {} is not in the vertex "
+                      "layout",
+                      input.name, input.location));
+    }
+  }
+}
+
 VulkanPipeline::VulkanPipeline(const VulkanDevice &device,
                                const VulkanRenderPass &render_pass,
                                const PipelineCreateInfo &info)
@@ -22,6 +85,15 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice &device,
   std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
   shader_stages.reserve(info.shader_set.size());
 
+  // Specialization constants, every stage gets the values of the constants
+  // it declares
+  std::vector<std::vector<VkSpecializationMapEntry>> specialization_entries;
+  std::vector<std::vector<uint32_t>> specialization_data;
+  std::vector<VkSpecializationInfo> specialization_infos;
+  specialization_entries.reserve(info.shader_set.size());
+  specialization_data.reserve(info.shader_set.size());
+  specialization_infos.reserve(info.shader_set.size());
+
   for (const auto &[stage, shader] : info.shader_set) {
     auto vulkan_shader = static_cast<VulkanShader *>(shader.get());
     VkPipelineShaderStageCreateInfo shader_stage_info{};
@@ -31,17 +103,81 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice &device,
     shader_stage_info.module = vulkan_shader->GetNativeShader();
     shader_stage_info.pName = "main";
 
+    auto &entries = specialization_entries.emplace_back();
+    auto &data = specialization_data.emplace_back();
+    for (const auto &constant :
+         shader->GetReflection().specialization_constants) {
+      auto it = info.specialization_constants.find(constant.id);
+      if (it == info.specialization_constants.end()) {
+        continue;
+      }
+
+      if (constant.size != sizeof(uint32_t)) {
+        throw RendererException(
+            Error::kInvalidShader,
+            fmt::format("Specialization constant {} is not a 32 bit value",
+                        constant.name));
+      }
+
+      if (constant.type != GetSpecializationType(it->second)) {
+        throw RendererException(
+            Error::kInvalidShader,
+            fmt::format("Specialization constant {} is set with a value of "
+                        "another type",
+                        constant.name));
+      }
+
+      entries.push_back(
+          {.constantID = constant.id,
+           .offset = static_cast<uint32_t>(data.size() * sizeof(uint32_t)),
+           .size = sizeof(uint32_t)});
+      data.push_back(GetSpecializationData(it->second));
+    }
+
+    if (!entries.empty()) {
+      shader_stage_info.pSpecializationInfo =
+          &specialization_infos.emplace_back(VkSpecializationInfo{
+              .mapEntryCount = static_cast<uint32_t>(entries.size()),
+              .pMapEntries = entries.data(),
+              .dataSize = data.size() * sizeof(uint32_t),
+              .pData = data.data()});
+    }
+
     shader_stages.push_back(shader_stage_info);
   }
 
-  // Vertex input
+  // Vertex input, the layout must provide every input of the vertex shader
+  ValidateVertexLayout(info);
+
+  std::vector<VkVertexInputBindingDescription> binding_descriptions{};
+  binding_descriptions.reserve(info.vertex_layout.buffers.size());
+  for (const auto &buffer : info.vertex_layout.buffers) {
+    binding_descriptions.push_back(
+        {.binding = buffer.binding,
+         .stride = buffer.stride,
+         .inputRate = GetVulkanVertexInputRate(buffer.input_rate)});
+  }
+
+  std::vector<VkVertexInputAttributeDescription> attribute_descriptions{};
+  attribute_descriptions.reserve(info.vertex_layout.attributes.size());
+  for (const auto &attribute : info.vertex_layout.attributes) {
+    attribute_descriptions.push_back(
+        {.location = attribute.location,
+         .binding = attribute.binding,
+         .format = GetVulkanFormat(attribute.format),
+         .offset = attribute.offset});
+  }
+
   VkPipelineVertexInputStateCreateInfo vertex_input_info{};
   vertex_input_info.sType =
       VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-  vertex_input_info.vertexBindingDescriptionCount = 0;
-  vertex_input_info.pVertexBindingDescriptions = nullptr;  // Optional
-  vertex_input_info.vertexAttributeDescriptionCount = 0;
-  vertex_input_info.pVertexAttributeDescriptions = nullptr;  // Optional
+  vertex_input_info.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(binding_descriptions.size());
+  vertex_input_info.pVertexBindingDescriptions = binding_descriptions.data();
+  vertex_input_info.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(attribute_descriptions.size());
+  vertex_input_info.pVertexAttributeDescriptions =
+      attribute_descriptions.data();
 
   // Input assembly
   VkPipelineInputAssemblyStateCreateInfo input_assembly{};
@@ -123,25 +259,13 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice &device,
   color_blending.blendConstants[2] = 0.0f;  // Optional
   color_blending.blendConstants[3] = 0.0f;  // Optional
 
-  // Pipeline layout
-  VkPipelineLayoutCreateInfo pipeline_layout_info{};
-  pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  pipeline_layout_info.setLayoutCount = 0;             // Optional
-  pipeline_layout_info.pSetLayouts = nullptr;          // Optional
-  pipeline_layout_info.pushConstantRangeCount = 0;     // Optional
-  pipeline_layout_info.pPushConstantRanges = nullptr;  // Optional
-
-  if (auto result = vkCreatePipelineLayout(device_, &pipeline_layout_info,
-                                           nullptr, &pipeline_layout_);
-      result != VK_SUCCESS) {
-    pipeline_layout_ = VK_NULL_HANDLE;
-    throw VulkanException(result, "Failed to create pipeline layout");
-  }
+  // Pipeline layout, shared with the pipelines with the same interface
+  pipeline_layout_ = device.GetLayoutCache().GetPipelineLayout(info.shader_set);
 
   // Pipeline
   VkGraphicsPipelineCreateInfo pipeline_info{};
   pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-  pipeline_info.stageCount = 2;
+  pipeline_info.stageCount = static_cast<uint32_t>(shader_stages.size());
   pipeline_info.pStages = shader_stages.data();
   pipeline_info.pVertexInputState = &vertex_input_info;
   pipeline_info.pInputAssemblyState = &input_assembly;
@@ -160,8 +284,6 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice &device,
   if (auto result = vkCreateGraphicsPipelines(
           device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_);
       result != VK_SUCCESS) {
-    vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
-    pipeline_layout_ = VK_NULL_HANDLE;
     pipeline_ = VK_NULL_HANDLE;
     throw VulkanException(result, "Failed to create graphics pipeline");
   }
@@ -173,10 +295,6 @@ VulkanPipeline::~VulkanPipeline() {
   if (pipeline_ != VK_NULL_HANDLE) {
     vkDestroyPipeline(device_, pipeline_, nullptr);
   }
-
-  if (pipeline_layout_ != VK_NULL_HANDLE) {
-    vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
-  }
 }
 
 }  // namespace chr::renderer::internal
\ No newline at end of file
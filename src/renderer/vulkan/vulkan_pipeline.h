@@ -28,9 +28,14 @@ struct VulkanPipeline : PipelineI {
   VulkanPipeline &operator=(VulkanPipeline &&other) = delete;
 
   auto GetNativePipeline() const -> VkPipeline { return pipeline_; }
+  auto GetNativePipelineLayout() const -> VkPipelineLayout {
+    return pipeline_layout_;
+  }
 
  private:
   VkDevice device_{VK_NULL_HANDLE};
+
+  // The layout is owned by the layout cache of the device.
   VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
   VkPipeline pipeline_{VK_NULL_HANDLE};
 };
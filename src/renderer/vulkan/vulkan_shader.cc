@@ -11,8 +11,9 @@
 namespace chr::renderer::internal {
 
 VulkanShader::VulkanShader(const VulkanDevice &device,
-                           const std::vector<uint8_t> &data)
-    : device_(device.GetNativeDevice()) {
+                           std::span<const uint8_t> data,
+                           ShaderReflection reflection)
+    : device_(device.GetNativeDevice()), reflection_(std::move(reflection)) {
   CHR_ZONE_SCOPED_VULKAN();
 
   VkShaderModuleCreateInfo createInfo{};
@@ -15,7 +15,8 @@ struct VulkanDevice;
 
 struct VulkanShader : ShaderI {
   explicit VulkanShader(const VulkanDevice &device,
-                        const std::vector<uint8_t> &data);
+                        std::span<const uint8_t> data,
+                        ShaderReflection reflection);
 
   VulkanShader(const VulkanShader &) = delete;
   VulkanShader(VulkanShader &&other) noexcept = delete;
@@ -25,11 +26,16 @@ struct VulkanShader : ShaderI {
   VulkanShader &operator=(const VulkanShader &) = delete;
   VulkanShader &operator=(VulkanShader &&other) = delete;
 
+  auto GetReflection() const -> const ShaderReflection & override {
+    return reflection_;
+  }
+
   auto GetNativeShader() const -> VkShaderModule { return shader_; }
 
  private:
   VkDevice device_{VK_NULL_HANDLE};
   VkShaderModule shader_{VK_NULL_HANDLE};
+  ShaderReflection reflection_{};
 };
 
 }  // namespace chr::renderer::internal
@@ -259,4 +259,48 @@ auto GetShaderStageFlagBits(ShaderStage stage) -> VkShaderStageFlagBits {
   return static_cast<VkShaderStageFlagBits>(0);
 }
 
+auto GetVulkanDescriptorType(DescriptorType type) -> VkDescriptorType {
+  switch (type) {
+    case DescriptorType::kSampler:
+      return VK_DESCRIPTOR_TYPE_SAMPLER;
+    case DescriptorType::kCombinedImageSampler:
+      return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    case DescriptorType::kSampledImage:
+      return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    case DescriptorType::kStorageImage:
+      return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    case DescriptorType::kUniformTexelBuffer:
+      return VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+    case DescriptorType::kStorageTexelBuffer:
+      return VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    case DescriptorType::kUniformBuffer:
+      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case DescriptorType::kStorageBuffer:
+      return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case DescriptorType::kInputAttachment:
+      return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    default:
+      break;
+  }
+
+  debug::Assert(false, "Unsupported descriptor type");
+
+  return static_cast<VkDescriptorType>(0);
+}
+
+auto GetVulkanVertexInputRate(VertexInputRate rate) -> VkVertexInputRate {
+  switch (rate) {
+    case VertexInputRate::kVertex:
+      return VK_VERTEX_INPUT_RATE_VERTEX;
+    case VertexInputRate::kInstance:
+      return VK_VERTEX_INPUT_RATE_INSTANCE;
+    default:
+      break;
+  }
+
+  debug::Assert(false, "Unsupported vertex input rate");
+
+  return VK_VERTEX_INPUT_RATE_VERTEX;
+}
+
 }  // namespace chr::renderer::internal
\ No newline at end of file
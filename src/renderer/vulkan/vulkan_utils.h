@@ -14,6 +14,8 @@ auto GetLocalError(VkResult result) -> Error;
 auto GetVulkanFormat(Format format) -> VkFormat;
 auto GetLocalFormat(VkFormat format) -> Format;
 auto GetShaderStageFlagBits(ShaderStage stage) -> VkShaderStageFlagBits;
+auto GetVulkanDescriptorType(DescriptorType type) -> VkDescriptorType;
+auto GetVulkanVertexInputRate(VertexInputRate rate) -> VkVertexInputRate;
 
 struct VulkanException : RendererException {
   explicit VulkanException(VkResult result, const std::string_view message)
@@ -0,0 +1,52 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "access_trace.h"
+
+#include <fstream>
+
+namespace chr::storage {
+
+auto AccessTrace::Save(const std::filesystem::path& path) const -> void {
+  CHR_ZONE_SCOPED();
+
+  std::ofstream stream{};
+  stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  stream.open(path, std::ios::trunc);
+
+  for (const auto& record : records) {
+    stream << record.range.offset << ' ' << record.range.size << ' '
+           << record.path << '\n';
+  }
+}
+
+auto AccessTrace::Load(const std::filesystem::path& path) -> AccessTrace {
+  CHR_ZONE_SCOPED();
+
+  std::ifstream stream{};
+  stream.exceptions(std::ifstream::badbit);
+  stream.open(path);
+  if (!stream.is_open()) {
+    throw std::filesystem::filesystem_error(
+        "Failed to open access trace", path,
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+
+  // The path is the rest of the line, so it can contain spaces.
+  AccessTrace trace{};
+  AccessRecord record{};
+  while (stream >> record.range.offset >> record.range.size &&
+         stream.get() == ' ' && std::getline(stream, record.path)) {
+    trace.records.push_back(record);
+  }
+
+  if (!stream.eof()) {
+    throw std::runtime_error(
+        fmt::format("Invalid access trace {}", path.string()));
+  }
+
+  return trace;
+}
+
+}  // namespace chr::storage
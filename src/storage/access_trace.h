@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_ACCESS_TRACE_H_
+#define CHR_STORAGE_ACCESS_TRACE_H_
+
+#include <filesystem>
+
+#include "pch.h"
+#include "read.h"
+
+namespace chr::storage {
+
+//! @brief Range of a file accessed during a run.
+struct AccessRecord {
+  //! @brief Normalized path of the file.
+  std::string path{};
+
+  //! @brief Range of bytes accessed.
+  ReadRange range{};
+};
+
+//! @brief Sequence of the file accesses of a run, in the order of the first
+//!        access. See Storage::StartAccessTrace and Storage::Prefetch.
+struct AccessTrace {
+  //! @brief Accessed ranges.
+  std::vector<AccessRecord> records{};
+
+  //! @brief Save the trace to a text file, one range per line.
+  //! @param path Path of the trace file on the local filesystem.
+  auto Save(const std::filesystem::path& path) const -> void;
+
+  //! @brief Load a trace saved with Save.
+  //! @param path Path of the trace file on the local filesystem.
+  //! @return Loaded trace.
+  static auto Load(const std::filesystem::path& path) -> AccessTrace;
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_ACCESS_TRACE_H_
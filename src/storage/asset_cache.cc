@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "asset_cache.h"
+
+namespace chr::storage {
+
+AssetCache::AssetCache(const Storage& storage) : storage_(storage) {}
+
+auto AssetCache::SetManifest(const Manifest& manifest) -> void {
+  std::lock_guard lock{mutex_};
+  for (size_t i = 0; i < manifest.Size(); i++) {
+    if (manifest.hashes[i] != 0) {
+      hashes_[manifest.ids[i]] = manifest.hashes[i];
+    }
+  }
+}
+
+auto AssetCache::Load(std::string_view path) -> AssetData {
+  CHR_ZONE_SCOPED();
+
+  auto id = HashPath(path);
+  {
+    std::lock_guard lock{mutex_};
+    if (auto it = hashes_.find(id); it != hashes_.end()) {
+      if (auto data = Find(it->second); data != nullptr) {
+        stats_.hits++;
+        stats_.bytes_not_read += data->size();
+        stats_.bytes_shared += data->size();
+        return data;
+      }
+    }
+  }
+
+  // The file is read without holding the lock, two threads that load the
+  // same content at the same time are merged below.
+  auto file = storage_.GetFile(path, FileMode::kMapped);
+  file.Open();
+  auto loaded = std::make_shared<const std::vector<uint8_t>>(file.ReadAll());
+  file.Close();
+  auto hash = HashContent(*loaded);
+
+  std::lock_guard lock{mutex_};
+  hashes_[id] = hash;
+  stats_.bytes_read += loaded->size();
+
+  // On a hash collision the new content replaces the old one in the table,
+  // the old data stays valid for who is holding it.
+  if (auto data = Find(hash); data != nullptr && *data == *loaded) {
+    stats_.duplicates++;
+    stats_.bytes_shared += data->size();
+    return data;
+  }
+
+  stats_.misses++;
+  data_[hash] = loaded;
+
+  // The released data leaves expired entries in the table, they are dropped
+  // when the table doubles in size.
+  if (data_.size() >= prune_size_) {
+    std::erase_if(data_, [](const auto& item) {
+      return item.second.expired();
+    });
+    prune_size_ = std::max(kAssetCachePruneSize, data_.size() * 2);
+  }
+  return loaded;
+}
+
+auto AssetCache::Forget(std::string_view path) -> void {
+  std::lock_guard lock{mutex_};
+  hashes_.erase(HashPath(path));
+}
+
+auto AssetCache::GetStats() const -> AssetCacheStats {
+  std::lock_guard lock{mutex_};
+  return stats_;
+}
+
+auto AssetCache::Find(ContentHash hash) const -> AssetData {
+  auto it = data_.find(hash);
+  return it != data_.end() ? it->second.lock() : nullptr;
+}
+
+}  // namespace chr::storage
@@ -0,0 +1,112 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_ASSET_CACHE_H_
+#define CHR_STORAGE_ASSET_CACHE_H_
+
+#include <mutex>
+#include <unordered_map>
+
+#include "hash.h"
+#include "manifest.h"
+#include "pch.h"
+#include "storage.h"
+
+namespace chr::storage {
+
+//! @brief Minimum number of entries of an AssetCache before the expired ones
+//!        are pruned.
+constexpr size_t kAssetCachePruneSize = 64;
+
+//! @brief Content of a file loaded through an AssetCache. It's shared by all
+//!        the paths with the same content.
+using AssetData = std::shared_ptr<const std::vector<uint8_t>>;
+
+//! @brief Counters of an AssetCache.
+struct AssetCacheStats {
+  //! @brief Loads served without reading the file, because the content of
+  //!        the path was already loaded.
+  uint64_t hits{0};
+
+  //! @brief Loads that read the file and found the same content already
+  //!        loaded from another path, the loaded copy is discarded.
+  uint64_t duplicates{0};
+
+  //! @brief Loads that read new content.
+  uint64_t misses{0};
+
+  //! @brief Bytes read from the storage.
+  uint64_t bytes_read{0};
+
+  //! @brief Bytes not read from the storage, thanks to the hits.
+  uint64_t bytes_not_read{0};
+
+  //! @brief Bytes of memory not allocated, thanks to the hits and the
+  //!        duplicates.
+  uint64_t bytes_shared{0};
+};
+
+//! @brief Load files from a storage sharing the ones with the same content.
+//!        The content is hashed (see HashContent) and the loaded data is
+//!        kept in a table by hash as long as someone holds it, so duplicate
+//!        assets are held in memory once and can be uploaded once (the
+//!        AssetData pointer can be the key of the GPU resources).
+//!        It's safe to call the methods from many threads.
+struct AssetCache {
+  //! @brief Create the cache.
+  //! @param storage Storage to read, it must outlive the cache.
+  explicit AssetCache(const Storage& storage);
+
+  //! @brief The copy constructor is not supported.
+  AssetCache(const AssetCache&) = delete;
+
+  //! @brief The move constructor is not supported.
+  AssetCache(AssetCache&&) noexcept = delete;
+
+  ~AssetCache() = default;
+
+  //! @brief The copy assignment operator is not supported.
+  AssetCache& operator=(const AssetCache&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  AssetCache& operator=(AssetCache&&) noexcept = delete;
+
+  //! @brief Use the hashes of a manifest (see Storage::BuildManifest), so a
+  //!        file whose content is already loaded from another path is not
+  //!        read at all. The manifest must be up to date with the storage.
+  //! @param manifest Manifest with the content hashes.
+  auto SetManifest(const Manifest& manifest) -> void;
+
+  //! @brief Load a file. When its content is already loaded (from the same
+  //!        path or from another path) the same data is returned.
+  //!        An exception is thrown if the file doesn't exist.
+  //! @param path File path.
+  //! @return File content.
+  auto Load(std::string_view path) -> AssetData;
+
+  //! @brief Forget the content of a path, so the next Load reads it again.
+  //!        It's intended to be called for the paths reported by
+  //!        Storage::PollChanges.
+  //! @param path Changed path.
+  auto Forget(std::string_view path) -> void;
+
+  //! @brief Get the counters of the cache.
+  //! @return Cache statistics.
+  [[nodiscard]] auto GetStats() const -> AssetCacheStats;
+
+ private:
+  auto Find(ContentHash hash) const -> AssetData;
+
+  const Storage& storage_;
+  mutable std::mutex mutex_{};
+  std::unordered_map<PathId, ContentHash> hashes_{};
+  std::unordered_map<ContentHash, std::weak_ptr<const std::vector<uint8_t>>>
+      data_{};
+  size_t prune_size_{kAssetCachePruneSize};
+  AssetCacheStats stats_{};
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_ASSET_CACHE_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "async_reader.h"
+
+#include "io_uring_reader.h"
+
+namespace chr::storage::internal {
+
+// Reads are I/O bound, few threads are enough to keep the device busy.
+constexpr size_t kAsyncReaderThreadCount = 4;
+
+// Maximum number of requests in flight on the io_uring submission queue.
+constexpr uint32_t kAsyncReaderQueueDepth = 256;
+
+AsyncReader::AsyncReader() {
+  if (IoUringReader::IsSupported()) {
+    try {
+      io_uring_ = std::make_unique<IoUringReader>(kAsyncReaderQueueDepth);
+    } catch (const std::exception& e) {
+      log::Warn("io_uring not available, fallback to thread pool ({})",
+                e.what());
+    }
+  }
+}
+
+AsyncReader::~AsyncReader() = default;
+
+auto AsyncReader::Submit(std::string path,
+                         const std::filesystem::path& native_path,
+                         const std::function<File()>& get_file,
+                         ReadRange range) -> AsyncReadId {
+  CHR_ZONE_SCOPED();
+
+  // Files on the local filesystem are read directly by the kernel, the others
+  // (pack files, etc.) are read on a worker thread through the file object.
+  if (io_uring_ != nullptr && !native_path.empty()) {
+    std::scoped_lock lock{mutex_};
+    auto id = next_id_++;
+    io_uring_->Submit(id, std::move(path), native_path, range);
+    return id;
+  }
+
+  auto file = get_file();
+
+  std::scoped_lock lock{mutex_};
+
+  auto id = next_id_++;
+
+  if (thread_pool_ == nullptr) {
+    thread_pool_ = std::make_unique<utils::ThreadPool>(kAsyncReaderThreadCount);
+  }
+
+  pending_++;
+  thread_pool_->Submit([this, id, path = std::move(path),
+                        file = std::move(file), range]() mutable {
+    ReadFile({.id = id, .path = std::move(path)}, std::move(file), range);
+  });
+
+  return id;
+}
+
+auto AsyncReader::Poll() -> std::vector<AsyncReadResult> {
+  CHR_ZONE_SCOPED();
+
+  std::scoped_lock lock{mutex_};
+
+  if (io_uring_ != nullptr) {
+    io_uring_->Process(false, completed_);
+  }
+
+  return std::exchange(completed_, {});
+}
+
+auto AsyncReader::Wait() -> void {
+  CHR_ZONE_SCOPED();
+
+  std::unique_lock lock{mutex_};
+
+  if (io_uring_ != nullptr) {
+    while (io_uring_->GetPendingCount() > 0) {
+      io_uring_->Process(true, completed_);
+    }
+  }
+
+  condition_.wait(lock, [this] { return pending_ == 0; });
+}
+
+auto AsyncReader::ReadFile(AsyncReadResult result, File file, ReadRange range)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  try {
+    file.Open();
+
+    auto size = range.size;
+    if (size == kWholeFile) {
+      file.Seek(0, SeekDir::kEnd);
+      size = file.Position() - std::min(file.Position(), range.offset);
+    }
+
+    result.data.resize(size);
+    file.ReadAt(range.offset, result.data.data(), size);
+    file.Close();
+
+    result.success = true;
+  } catch (const std::exception& e) {
+    result.error = e.what();
+    result.data.clear();
+  }
+
+  {
+    std::scoped_lock lock{mutex_};
+    completed_.push_back(std::move(result));
+    pending_--;
+  }
+
+  condition_.notify_all();
+}
+
+}  // namespace chr::storage::internal
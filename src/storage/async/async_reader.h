@@ -0,0 +1,55 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_ASYNC_ASYNC_READER_H_
+#define CHR_STORAGE_ASYNC_ASYNC_READER_H_
+
+#include <filesystem>
+#include <functional>
+
+#include "file.h"
+#include "pch.h"
+#include "read.h"
+
+namespace chr::storage::internal {
+
+struct IoUringReader;
+
+struct AsyncReader {
+  explicit AsyncReader();
+
+  AsyncReader(const AsyncReader&) = delete;
+  AsyncReader(AsyncReader&& other) noexcept = delete;
+
+  ~AsyncReader();
+
+  AsyncReader& operator=(const AsyncReader&) = delete;
+  AsyncReader& operator=(AsyncReader&& other) noexcept = delete;
+
+  // The file is only built for the reads that run on the thread pool.
+  auto Submit(std::string path, const std::filesystem::path& native_path,
+              const std::function<File()>& get_file, ReadRange range)
+      -> AsyncReadId;
+  auto Poll() -> std::vector<AsyncReadResult>;
+  auto Wait() -> void;
+
+ private:
+  auto ReadFile(AsyncReadResult result, File file, ReadRange range) -> void;
+
+  std::mutex mutex_{};
+  std::condition_variable condition_{};
+  std::vector<AsyncReadResult> completed_{};
+  size_t pending_{0};
+  AsyncReadId next_id_{1};
+
+  std::unique_ptr<IoUringReader> io_uring_{};
+
+  // Declared last, so the worker threads are stopped before anything else is
+  // destroyed.
+  std::unique_ptr<utils::ThreadPool> thread_pool_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_ASYNC_ASYNC_READER_H_
@@ -0,0 +1,259 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "io_uring_reader.h"
+
+#include <ranges>
+#include <system_error>
+
+#if defined(CHR_STORAGE_IO_URING)
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chr::storage::internal {
+
+#if defined(CHR_STORAGE_IO_URING)
+
+struct IoUringRequest {
+  AsyncReadId id{0};
+  std::string path{};
+  int fd{-1};
+  size_t offset{0};
+  size_t done{0};
+  std::vector<uint8_t> data{};
+};
+
+struct IoUringState {
+  io_uring ring{};
+  std::unordered_map<IoUringRequest*, std::unique_ptr<IoUringRequest>>
+      requests{};
+  std::vector<AsyncReadResult> early_completed{};
+
+  // Entries prepared in the submission queue and not submitted yet.
+  std::vector<std::pair<io_uring_sqe*, IoUringRequest*>> queued{};
+};
+
+IoUringReader::IoUringReader(uint32_t queue_depth)
+    : state_{std::make_unique<IoUringState>()} {
+  CHR_ZONE_SCOPED();
+
+  if (auto result = io_uring_queue_init(queue_depth, &state_->ring, 0);
+      result < 0) {
+    throw std::system_error(-result, std::generic_category(),
+                            "Failed to create io_uring");
+  }
+}
+
+IoUringReader::~IoUringReader() {
+  CHR_ZONE_SCOPED();
+
+  // The kernel can still write into the buffers of the requests in flight.
+  std::vector<AsyncReadResult> completed{};
+  while (!state_->requests.empty()) {
+    Process(true, completed);
+  }
+
+  io_uring_queue_exit(&state_->ring);
+}
+
+auto IoUringReader::IsSupported() -> bool { return true; }
+
+auto IoUringReader::GetPendingCount() const -> size_t {
+  return state_->requests.size();
+}
+
+auto IoUringReader::Submit(AsyncReadId id, std::string path,
+                           const std::filesystem::path& native_path,
+                           ReadRange range) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto request = std::make_unique<IoUringRequest>();
+  request->id = id;
+  request->path = std::move(path);
+  request->offset = range.offset;
+
+  auto* request_ptr = request.get();
+  state_->requests.try_emplace(request_ptr, std::move(request));
+
+  request_ptr->fd = open(native_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (request_ptr->fd == -1) {
+    Complete(request_ptr, std::system_category().message(errno),
+             state_->early_completed);
+    return;
+  }
+
+  auto size = range.size;
+  if (size == kWholeFile) {
+    struct stat file_stat {};
+    if (fstat(request_ptr->fd, &file_stat) == -1) {
+      Complete(request_ptr, std::system_category().message(errno),
+               state_->early_completed);
+      return;
+    }
+
+    auto file_size = static_cast<size_t>(file_stat.st_size);
+    size = file_size - std::min(file_size, range.offset);
+  }
+
+  request_ptr->data.resize(size);
+  if (size == 0) {
+    Complete(request_ptr, {}, state_->early_completed);
+    return;
+  }
+
+  Queue(request_ptr, state_->early_completed);
+}
+
+auto IoUringReader::Process(bool wait, std::vector<AsyncReadResult>& completed)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  std::ranges::move(state_->early_completed, std::back_inserter(completed));
+  state_->early_completed.clear();
+
+  // All the requests queued since the last call are submitted together.
+  Flush(completed);
+
+  if (state_->requests.empty()) {
+    return;
+  }
+
+  io_uring_cqe* cqe = nullptr;
+  auto result = wait ? io_uring_wait_cqe(&state_->ring, &cqe)
+                     : io_uring_peek_cqe(&state_->ring, &cqe);
+
+  while (result == 0 && cqe != nullptr) {
+    auto* request = static_cast<IoUringRequest*>(io_uring_cqe_get_data(cqe));
+    auto bytes = cqe->res;
+    io_uring_cqe_seen(&state_->ring, cqe);
+
+    if (request == nullptr) {
+      // Entry of a request that failed to submit.
+    } else if (bytes < 0) {
+      Complete(request, std::system_category().message(-bytes), completed);
+    } else if (bytes == 0) {
+      Complete(request, "Read past the end of file", completed);
+    } else {
+      request->done += static_cast<size_t>(bytes);
+      if (request->done < request->data.size()) {
+        // Short read, queue the remaining part.
+        Queue(request, completed);
+      } else {
+        Complete(request, {}, completed);
+      }
+    }
+
+    result = io_uring_peek_cqe(&state_->ring, &cqe);
+  }
+
+  Flush(completed);
+}
+
+auto IoUringReader::Queue(IoUringRequest* request,
+                          std::vector<AsyncReadResult>& completed) -> void {
+  auto* sqe = io_uring_get_sqe(&state_->ring);
+  if (sqe == nullptr) {
+    // The submission queue is full, flush it to make room.
+    Flush(completed);
+    sqe = io_uring_get_sqe(&state_->ring);
+  }
+
+  if (sqe == nullptr) {
+    Complete(request, "The io_uring submission queue is full", completed);
+    return;
+  }
+
+  auto remaining = request->data.size() - request->done;
+  io_uring_prep_read(
+      sqe, request->fd, request->data.data() + request->done,
+      static_cast<unsigned>(std::min<size_t>(remaining, 1u << 30)),
+      request->offset + request->done);
+  io_uring_sqe_set_data(sqe, request);
+
+  state_->queued.emplace_back(sqe, request);
+}
+
+auto IoUringReader::Flush(std::vector<AsyncReadResult>& completed) -> void {
+  if (state_->queued.empty()) {
+    return;
+  }
+
+  auto result = io_uring_submit(&state_->ring);
+  auto submitted = static_cast<size_t>(std::max(result, 0));
+  if (submitted < state_->queued.size()) {
+    // The entries not consumed by the kernel stay in the submission queue,
+    // they become no-ops so their completions don't reference the failed
+    // requests.
+    auto error = result < 0 ? std::system_category().message(-result)
+                            : std::string{"Failed to submit the read"};
+    for (auto [sqe, request] : state_->queued | std::views::drop(submitted)) {
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      Complete(request, error, completed);
+    }
+  }
+
+  state_->queued.clear();
+}
+
+auto IoUringReader::Complete(IoUringRequest* request, std::string error,
+                             std::vector<AsyncReadResult>& completed) -> void {
+  if (request->fd != -1) {
+    close(request->fd);
+  }
+
+  AsyncReadResult result{.id = request->id,
+                         .path = std::move(request->path),
+                         .success = error.empty(),
+                         .error = std::move(error)};
+  if (result.success) {
+    result.data = std::move(request->data);
+  }
+
+  completed.push_back(std::move(result));
+  state_->requests.erase(request);
+}
+
+#else
+
+struct IoUringRequest {};
+struct IoUringState {};
+
+IoUringReader::IoUringReader(uint32_t /*queue_depth*/) {
+  throw std::system_error(std::make_error_code(std::errc::not_supported),
+                          "io_uring is not supported");
+}
+
+IoUringReader::~IoUringReader() = default;
+
+auto IoUringReader::IsSupported() -> bool { return false; }
+
+auto IoUringReader::GetPendingCount() const -> size_t { return 0; }
+
+auto IoUringReader::Submit(AsyncReadId /*id*/, std::string /*path*/,
+                           const std::filesystem::path& /*native_path*/,
+                           ReadRange /*range*/) -> void {}
+
+auto IoUringReader::Process(bool /*wait*/,
+                            std::vector<AsyncReadResult>& /*completed*/)
+    -> void {}
+
+auto IoUringReader::Queue(IoUringRequest* /*request*/,
+                          std::vector<AsyncReadResult>& /*completed*/)
+    -> void {}
+
+auto IoUringReader::Flush(std::vector<AsyncReadResult>& /*completed*/)
+    -> void {}
+
+auto IoUringReader::Complete(IoUringRequest* /*request*/,
+                             std::string /*error*/,
+                             std::vector<AsyncReadResult>& /*completed*/)
+    -> void {}
+
+#endif
+
+}  // namespace chr::storage::internal
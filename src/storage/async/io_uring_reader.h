@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_ASYNC_IO_URING_READER_H_
+#define CHR_STORAGE_ASYNC_IO_URING_READER_H_
+
+#include <filesystem>
+
+#include "pch.h"
+#include "read.h"
+
+namespace chr::storage::internal {
+
+struct IoUringRequest;
+struct IoUringState;
+
+struct IoUringReader {
+  explicit IoUringReader(uint32_t queue_depth);
+
+  IoUringReader(const IoUringReader&) = delete;
+  IoUringReader(IoUringReader&& other) noexcept = delete;
+
+  ~IoUringReader();
+
+  IoUringReader& operator=(const IoUringReader&) = delete;
+  IoUringReader& operator=(IoUringReader&& other) noexcept = delete;
+
+  static auto IsSupported() -> bool;
+
+  auto Submit(AsyncReadId id, std::string path,
+              const std::filesystem::path& native_path, ReadRange range)
+      -> void;
+  auto Process(bool wait, std::vector<AsyncReadResult>& completed) -> void;
+  auto GetPendingCount() const -> size_t;
+
+ private:
+  auto Queue(IoUringRequest* request, std::vector<AsyncReadResult>& completed)
+      -> void;
+  auto Flush(std::vector<AsyncReadResult>& completed) -> void;
+  auto Complete(IoUringRequest* request, std::string error,
+                std::vector<AsyncReadResult>& completed) -> void;
+
+  std::unique_ptr<IoUringState> state_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_ASYNC_IO_URING_READER_H_
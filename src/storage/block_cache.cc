@@ -0,0 +1,115 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "block_cache.h"
+
+namespace chr::storage {
+
+constexpr size_t kBlockCacheShardCount = 16;
+
+// Every shard must hold at least one block, a small cache has fewer shards.
+static auto GetShardCount(size_t capacity, size_t block_size) -> size_t {
+  if (block_size == 0) {
+    throw std::invalid_argument("The block size must be greater than zero");
+  }
+
+  if (capacity < block_size) {
+    throw std::invalid_argument(
+        fmt::format("The block cache capacity {} is smaller than a block ({})",
+                    capacity, block_size));
+  }
+
+  return std::min(capacity / block_size, kBlockCacheShardCount);
+}
+
+BlockCache::BlockCache(size_t capacity, size_t block_size)
+    : capacity_{capacity},
+      block_size_{block_size},
+      shards_(GetShardCount(capacity, block_size)) {}
+
+auto BlockCache::Read(uint64_t file_id, size_t block, size_t offset,
+                      uint8_t* buffer, size_t size) -> bool {
+  BlockKey key{.file_id = file_id, .block = block};
+  auto& shard = GetShard(key);
+
+  std::lock_guard lock{shard.mutex};
+  auto it = shard.index.find(key);
+  if (it == shard.index.end() || offset + size > it->second->data.size()) {
+    shard.misses++;
+    return false;
+  }
+
+  shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+  std::memcpy(buffer, it->second->data.data() + offset, size);
+  shard.hits++;
+  return true;
+}
+
+auto BlockCache::Insert(uint64_t file_id, size_t block,
+                        std::vector<uint8_t> data) -> void {
+  BlockKey key{.file_id = file_id, .block = block};
+  auto& shard = GetShard(key);
+
+  // Every shard gets an equal part of the capacity, the keys are spread
+  // evenly by the hash. A shard holds at least one block, see GetShardCount.
+  auto shard_capacity = capacity_ / shards_.size();
+  if (data.size() > shard_capacity) {
+    return;
+  }
+
+  std::lock_guard lock{shard.mutex};
+  if (auto it = shard.index.find(key); it != shard.index.end()) {
+    shard.memory_used -= it->second->data.size();
+    shard.blocks.erase(it->second);
+    shard.index.erase(it);
+  }
+
+  while (!shard.blocks.empty() &&
+         shard.memory_used + data.size() > shard_capacity) {
+    auto& last = shard.blocks.back();
+    shard.memory_used -= last.data.size();
+    shard.index.erase(last.key);
+    shard.blocks.pop_back();
+    shard.evictions++;
+  }
+
+  shard.memory_used += data.size();
+  shard.blocks.push_front({.key = key, .data = std::move(data)});
+  shard.index.emplace(key, shard.blocks.begin());
+}
+
+auto BlockCache::Clear() -> void {
+  for (auto& shard : shards_) {
+    std::lock_guard lock{shard.mutex};
+    shard.index.clear();
+    shard.blocks.clear();
+    shard.memory_used = 0;
+  }
+}
+
+auto BlockCache::GetStats() const -> BlockCacheStats {
+  BlockCacheStats stats{.capacity = capacity_};
+  for (const auto& shard : shards_) {
+    std::lock_guard lock{shard.mutex};
+    stats.hits += shard.hits;
+    stats.misses += shard.misses;
+    stats.evictions += shard.evictions;
+    stats.memory_used += shard.memory_used;
+  }
+
+  return stats;
+}
+
+auto BlockCache::BlockKeyHash::operator()(const BlockKey& key) const
+    -> size_t {
+  // Consecutive blocks of a file land on different shards.
+  auto hash = key.file_id ^ (key.block * 0x9e3779b97f4a7c15ULL);
+  return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+auto BlockCache::GetShard(const BlockKey& key) -> Shard& {
+  return shards_[BlockKeyHash{}(key) % shards_.size()];
+}
+
+}  // namespace chr::storage
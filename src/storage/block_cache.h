@@ -0,0 +1,135 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_BLOCK_CACHE_H_
+#define CHR_STORAGE_BLOCK_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Default size of the blocks of a BlockCache.
+constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+//! @brief Counters of a BlockCache.
+struct BlockCacheStats {
+  //! @brief Reads served from the cache.
+  uint64_t hits{0};
+
+  //! @brief Reads that loaded a block from the file.
+  uint64_t misses{0};
+
+  //! @brief Blocks dropped to make room for new ones.
+  uint64_t evictions{0};
+
+  //! @brief Bytes held by the cached blocks.
+  size_t memory_used{0};
+
+  //! @brief Maximum number of bytes held by the cached blocks.
+  size_t capacity{0};
+};
+
+//! @brief Size bounded cache of fixed size blocks of file data, with least
+//!        recently used eviction. The same cache can be shared by many
+//!        storages, see Storage::SetBlockCache.
+//!        The blocks are spread on independent shards, every one with its
+//!        own lock, so concurrent reads of different blocks don't wait on
+//!        each other. A small cache has fewer shards, every shard can hold
+//!        at least one block. It's safe to call the methods from many threads.
+struct BlockCache {
+  //! @brief Create the cache.
+  //! @param capacity Maximum number of bytes held by the cached blocks.
+  //! @param block_size Size of the blocks. Reads at least this big are not
+  //!                   cached.
+  //! @exception std::invalid_argument The block size is zero or the capacity
+  //!            is smaller than a block.
+  explicit BlockCache(size_t capacity, size_t block_size = kDefaultBlockSize);
+
+  //! @brief The copy constructor is not supported.
+  BlockCache(const BlockCache&) = delete;
+
+  //! @brief The move constructor is not supported.
+  BlockCache(BlockCache&&) noexcept = delete;
+
+  ~BlockCache() = default;
+
+  //! @brief The copy assignment operator is not supported.
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  //! @brief The move assignment operator is not supported.
+  BlockCache& operator=(BlockCache&&) noexcept = delete;
+
+  //! @brief Get the size of the blocks.
+  //! @return Block size.
+  [[nodiscard]] auto BlockSize() const -> size_t { return block_size_; }
+
+  //! @brief Copy data from a cached block, it's used by the storage backends.
+  //! @param file_id Identifier of the file content, it must change when the
+  //!                file is modified.
+  //! @param block Index of the block in the file.
+  //! @param offset Offset of the data in the block.
+  //! @param buffer Destination buffer.
+  //! @param size Number of bytes to copy.
+  //! @return True if the block is cached and the data was copied.
+  auto Read(uint64_t file_id, size_t block, size_t offset, uint8_t* buffer,
+            size_t size) -> bool;
+
+  //! @brief Add a block to the cache, it's used by the storage backends. The
+  //!        last block of a file can be smaller than the block size.
+  //! @param file_id Identifier of the file content.
+  //! @param block Index of the block in the file.
+  //! @param data Block data.
+  auto Insert(uint64_t file_id, size_t block, std::vector<uint8_t> data)
+      -> void;
+
+  //! @brief Drop all the cached blocks.
+  auto Clear() -> void;
+
+  //! @brief Get the counters of the cache.
+  //! @return Cache statistics.
+  [[nodiscard]] auto GetStats() const -> BlockCacheStats;
+
+ private:
+  struct BlockKey {
+    uint64_t file_id;
+    size_t block;
+
+    auto operator==(const BlockKey&) const -> bool = default;
+  };
+
+  struct BlockKeyHash {
+    auto operator()(const BlockKey& key) const -> size_t;
+  };
+
+  struct CachedBlock {
+    BlockKey key;
+    std::vector<uint8_t> data;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex{};
+    std::list<CachedBlock> blocks{};  // Most recently used first.
+    std::unordered_map<BlockKey, std::list<CachedBlock>::iterator,
+                       BlockKeyHash>
+        index{};
+    size_t memory_used{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+  };
+
+  auto GetShard(const BlockKey& key) -> Shard&;
+
+  size_t capacity_;
+  size_t block_size_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_BLOCK_CACHE_H_
@@ -0,0 +1,203 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "chunked_data.h"
+
+#include <cstring>
+#include <ios>
+
+#include "lz_codec.h"
+
+namespace chr::storage::internal {
+
+// Reads that touch fewer chunks are decompressed on the calling thread.
+constexpr size_t kParallelChunkCount = 4;
+
+static auto GetThreadPool() -> utils::ThreadPool& {
+  static utils::ThreadPool thread_pool{};
+  return thread_pool;
+}
+
+// Run fun(index) for every index in [first, last], on the worker threads when
+// there are enough of them. Every task is waited for, even if one fails.
+template <typename Fun>
+static auto ForEachChunk(size_t first, size_t last, Fun fun) -> void {
+  if (last - first + 1 < kParallelChunkCount) {
+    for (auto index = first; index <= last; index++) {
+      fun(index);
+    }
+    return;
+  }
+
+  std::vector<std::future<void>> futures{};
+  futures.reserve(last - first + 1);
+  for (auto index = first; index <= last; index++) {
+    futures.push_back(GetThreadPool().Submit([&fun, index] { fun(index); }));
+  }
+
+  std::exception_ptr error{};
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+ChunkedData::ChunkedData(std::span<const uint8_t> data) : data_{data} {
+  if (data_.size() < sizeof(header_)) {
+    throw std::runtime_error("Invalid compressed data");
+  }
+
+  std::memcpy(&header_, data_.data(), sizeof(header_));
+  if (header_.magic != kChunkedMagic) {
+    throw std::runtime_error("Invalid compressed data");
+  }
+
+  if (header_.version != kChunkedVersion) {
+    throw std::runtime_error("Unsupported compressed data version");
+  }
+
+  if (header_.chunk_size == 0 ||
+      header_.chunk_count !=
+          (header_.size + header_.chunk_size - 1) / header_.chunk_size ||
+      (data_.size() - sizeof(header_)) / sizeof(uint64_t) <=
+          header_.chunk_count) {
+    throw std::runtime_error("Invalid compressed data");
+  }
+
+  auto data_offset =
+      sizeof(header_) + (size_t{header_.chunk_count} + 1) * sizeof(uint64_t);
+  if (ChunkOffset(0) != data_offset) {
+    throw std::runtime_error("Invalid compressed data");
+  }
+
+  for (size_t i = 0; i < header_.chunk_count; i++) {
+    auto begin = ChunkOffset(i);
+    auto end = ChunkOffset(i + 1);
+    if (end < begin || end > data_.size() || end - begin > ChunkLength(i)) {
+      throw std::runtime_error("Invalid compressed data");
+    }
+  }
+}
+
+auto ChunkedData::ChunkLength(size_t index) const -> size_t {
+  auto begin = index * header_.chunk_size;
+  return std::min<size_t>(header_.chunk_size, header_.size - begin);
+}
+
+auto ChunkedData::DecompressChunk(size_t index,
+                                  std::span<uint8_t> output) const -> void {
+  auto begin = ChunkOffset(index);
+  auto end = ChunkOffset(index + 1);
+  auto chunk = data_.subspan(begin, end - begin);
+
+  if (chunk.size() == output.size()) {
+    std::memcpy(output.data(), chunk.data(), chunk.size());
+  } else {
+    LzDecompress(chunk, output);
+  }
+}
+
+auto ChunkedData::Read(size_t offset, uint8_t* buffer, size_t size) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  if (offset > header_.size || size > header_.size - offset) {
+    throw std::ios_base::failure("Read past the end of file");
+  }
+
+  if (size == 0) {
+    return;
+  }
+
+  auto first = offset / header_.chunk_size;
+  auto last = (offset + size - 1) / header_.chunk_size;
+
+  ForEachChunk(first, last, [&](size_t index) {
+    auto chunk_begin = index * header_.chunk_size;
+    auto chunk_length = ChunkLength(index);
+    auto from = std::max(offset, chunk_begin) - chunk_begin;
+    auto to = std::min(offset + size, chunk_begin + chunk_length) - chunk_begin;
+    auto* destination = buffer + (chunk_begin + from - offset);
+
+    // Whole chunks are decompressed straight into the caller buffer.
+    if (from == 0 && to == chunk_length) {
+      DecompressChunk(index, {destination, chunk_length});
+      return;
+    }
+
+    std::vector<uint8_t> chunk(chunk_length);
+    DecompressChunk(index, chunk);
+    std::memcpy(destination, chunk.data() + from, to - from);
+  });
+}
+
+auto ChunkedData::ChunkOffset(size_t index) const -> uint64_t {
+  uint64_t offset{};
+  std::memcpy(&offset,
+              data_.data() + sizeof(header_) + index * sizeof(uint64_t),
+              sizeof(offset));
+  return offset;
+}
+
+auto CompressChunked(std::span<const uint8_t> input, uint32_t chunk_size)
+    -> std::vector<uint8_t> {
+  CHR_ZONE_SCOPED();
+
+  debug::Assert(chunk_size > 0, "Invalid chunk size");
+
+  ChunkedHeader header{
+      .magic = kChunkedMagic,
+      .version = kChunkedVersion,
+      .size = input.size(),
+      .chunk_size = chunk_size,
+      .chunk_count =
+          static_cast<uint32_t>((input.size() + chunk_size - 1) / chunk_size)};
+
+  std::vector<std::vector<uint8_t>> chunks(header.chunk_count);
+  if (!chunks.empty()) {
+    ForEachChunk(0, chunks.size() - 1, [&](size_t index) {
+      auto begin = index * chunk_size;
+      auto chunk = input.subspan(
+          begin, std::min<size_t>(chunk_size, input.size() - begin));
+      auto compressed = LzCompress(chunk);
+      if (compressed.size() < chunk.size()) {
+        chunks[index] = std::move(compressed);
+      } else {
+        chunks[index].assign(chunk.begin(), chunk.end());
+      }
+    });
+  }
+
+  std::vector<uint64_t> offsets{};
+  offsets.reserve(chunks.size() + 1);
+  uint64_t offset = sizeof(header) + (chunks.size() + 1) * sizeof(uint64_t);
+  for (const auto& chunk : chunks) {
+    offsets.push_back(offset);
+    offset += chunk.size();
+  }
+  offsets.push_back(offset);
+
+  std::vector<uint8_t> output(sizeof(header) +
+                              offsets.size() * sizeof(uint64_t));
+  std::memcpy(output.data(), &header, sizeof(header));
+  std::memcpy(output.data() + sizeof(header), offsets.data(),
+              offsets.size() * sizeof(uint64_t));
+  output.reserve(offset);
+  for (const auto& chunk : chunks) {
+    output.insert(output.end(), chunk.begin(), chunk.end());
+  }
+
+  return output;
+}
+
+}  // namespace chr::storage::internal
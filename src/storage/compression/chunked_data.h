@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_COMPRESSION_CHUNKED_DATA_H_
+#define CHR_STORAGE_COMPRESSION_CHUNKED_DATA_H_
+
+#include <span>
+
+#include "chunked_format.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+// Read-only view of a compressed container, see chunked_format.h. All the
+// methods are const and don't share any state, so they can be called
+// concurrently.
+struct ChunkedData {
+  explicit ChunkedData(std::span<const uint8_t> data);
+
+  auto Size() const -> size_t { return header_.size; }
+  auto ChunkSize() const -> size_t { return header_.chunk_size; }
+  auto ChunkCount() const -> size_t { return header_.chunk_count; }
+  auto ChunkLength(size_t index) const -> size_t;
+
+  auto DecompressChunk(size_t index, std::span<uint8_t> output) const -> void;
+  auto Read(size_t offset, uint8_t* buffer, size_t size) const -> void;
+
+ private:
+  auto ChunkOffset(size_t index) const -> uint64_t;
+
+  std::span<const uint8_t> data_;
+  ChunkedHeader header_{};
+};
+
+auto CompressChunked(std::span<const uint8_t> input,
+                     uint32_t chunk_size = kDefaultChunkSize)
+    -> std::vector<uint8_t>;
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_COMPRESSION_CHUNKED_DATA_H_
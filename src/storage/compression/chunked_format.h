@@ -0,0 +1,39 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_COMPRESSION_CHUNKED_FORMAT_H_
+#define CHR_STORAGE_COMPRESSION_CHUNKED_FORMAT_H_
+
+#include "pch.h"
+
+// Compressed container layout (little endian):
+//
+//   ChunkedHeader
+//   uint64_t[chunk_count + 1]  chunk offsets from the start of the container
+//   chunk data                 every chunk compressed on its own
+//
+// The content is split in chunks of chunk_size bytes (the last one can be
+// smaller) that can be decompressed independently. A chunk that doesn't
+// shrink is stored as it is, so a chunk is compressed only when its stored
+// size is different from its uncompressed size.
+
+namespace chr::storage::internal {
+
+constexpr std::array<char, 4> kChunkedMagic{'C', 'H', 'R', 'Z'};
+constexpr uint32_t kChunkedVersion = 1;
+constexpr uint32_t kDefaultChunkSize = 64 * 1024;
+
+struct ChunkedHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint64_t size;
+  uint32_t chunk_size;
+  uint32_t chunk_count;
+};
+
+static_assert(sizeof(ChunkedHeader) == 24);
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_COMPRESSION_CHUNKED_FORMAT_H_
@@ -0,0 +1,69 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "compressed_file.h"
+
+#include <cstring>
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(CompressedFile) <= kFileSize);
+
+auto CompressedFile::Open() -> void {
+  CHR_ZONE_SCOPED();
+
+  chunked_.emplace(data_);
+  cursor_.Reset();
+}
+
+auto CompressedFile::Close() -> void {
+  chunked_.reset();
+  cursor_.Reset();
+  cache_ = {};
+  cached_chunk_ = kNoChunk;
+}
+
+auto CompressedFile::Read(uint8_t* buffer, size_t size) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto position = cursor_.Position();
+  if (!chunked_ || size == 0 || size > chunked_->Size() - position) {
+    ReadAt(position, buffer, size);
+    cursor_.Advance(size);
+    return;
+  }
+
+  // Small sequential reads usually hit the same chunk, so the last one is
+  // kept decompressed. Reads across chunks go straight to the caller buffer.
+  auto index = position / chunked_->ChunkSize();
+  if (index != (position + size - 1) / chunked_->ChunkSize()) {
+    chunked_->Read(position, buffer, size);
+    cursor_.Advance(size);
+    return;
+  }
+
+  if (cached_chunk_ != index) {
+    cached_chunk_ = kNoChunk;
+    cache_.resize(chunked_->ChunkLength(index));
+    chunked_->DecompressChunk(index, cache_);
+    cached_chunk_ = index;
+  }
+
+  std::memcpy(buffer,
+              cache_.data() + (position - index * chunked_->ChunkSize()),
+              size);
+  cursor_.Advance(size);
+}
+
+auto CompressedFile::ReadAt(size_t offset, uint8_t* buffer, size_t size) const
+    -> void {
+  if (!chunked_) {
+    FileCursor::ReadAt({}, offset, buffer, size);
+    return;
+  }
+
+  chunked_->Read(offset, buffer, size);
+}
+
+}  // namespace chr::storage::internal
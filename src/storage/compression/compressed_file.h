@@ -0,0 +1,60 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_COMPRESSION_COMPRESSED_FILE_H_
+#define CHR_STORAGE_COMPRESSION_COMPRESSED_FILE_H_
+
+#include <optional>
+
+#include "chunked_data.h"
+#include "file.h"
+#include "file_cursor.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+// File backed by a compressed container held in memory by its owner (ex. a
+// pack archive). Only the chunks touched by a read are decompressed.
+struct CompressedFile : FileI {
+  explicit CompressedFile(std::shared_ptr<const void> owner,
+                          std::span<const uint8_t> data)
+      : owner_{std::move(owner)}, data_{data} {};
+
+  CompressedFile(const CompressedFile&) = delete;
+  CompressedFile(CompressedFile&& other) noexcept
+      : owner_{std::move(other.owner_)},
+        data_{other.data_},
+        chunked_{other.chunked_},
+        cursor_{other.cursor_},
+        cache_{std::move(other.cache_)},
+        cached_chunk_{other.cached_chunk_} {}
+
+  CompressedFile& operator=(const CompressedFile&) = delete;
+  CompressedFile& operator=(CompressedFile&& other) noexcept = delete;
+
+  auto Open() -> void;
+  auto IsOpen() const -> bool { return chunked_.has_value(); }
+  auto Close() -> void;
+  auto Seek(size_t offset, SeekDir direction) -> void {
+    cursor_.Seek(chunked_ ? chunked_->Size() : 0, offset, direction);
+  }
+  auto Position() -> size_t { return cursor_.Position(); }
+  auto Read(uint8_t* buffer, size_t size) -> void;
+  auto Map() const -> std::span<const uint8_t> { return {}; }
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void;
+
+ private:
+  static constexpr size_t kNoChunk = std::numeric_limits<size_t>::max();
+
+  std::shared_ptr<const void> owner_;
+  std::span<const uint8_t> data_;
+  std::optional<ChunkedData> chunked_{};
+  FileCursor cursor_{};
+  std::vector<uint8_t> cache_{};
+  size_t cached_chunk_{kNoChunk};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_COMPRESSION_COMPRESSED_FILE_H_
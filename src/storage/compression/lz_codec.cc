@@ -0,0 +1,173 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "lz_codec.h"
+
+#include <cstring>
+#include <limits>
+
+namespace chr::storage::internal {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr size_t kHashBits = 16;
+constexpr uint8_t kNibbleMax = 15;
+
+static auto Load32(const uint8_t* data) -> uint32_t {
+  uint32_t value{};
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static auto HashSequence(uint32_t sequence) -> size_t {
+  return (sequence * 2654435761U) >> (32 - kHashBits);
+}
+
+static auto WriteLength(std::vector<uint8_t>& output, size_t length) -> void {
+  for (; length >= 255; length -= 255) {
+    output.push_back(255);
+  }
+  output.push_back(static_cast<uint8_t>(length));
+}
+
+static auto WriteSequence(std::vector<uint8_t>& output,
+                          std::span<const uint8_t> literals, size_t offset,
+                          size_t match_length) -> void {
+  auto literal_nibble = std::min<size_t>(literals.size(), kNibbleMax);
+  auto match_nibble =
+      match_length == 0
+          ? 0
+          : std::min<size_t>(match_length - kMinMatch, kNibbleMax);
+  output.push_back(static_cast<uint8_t>(literal_nibble << 4 | match_nibble));
+
+  if (literal_nibble == kNibbleMax) {
+    WriteLength(output, literals.size() - kNibbleMax);
+  }
+  output.insert(output.end(), literals.begin(), literals.end());
+
+  // The last sequence has no match.
+  if (match_length == 0) {
+    return;
+  }
+
+  output.push_back(static_cast<uint8_t>(offset));
+  output.push_back(static_cast<uint8_t>(offset >> 8));
+
+  if (match_nibble == kNibbleMax) {
+    WriteLength(output, match_length - kMinMatch - kNibbleMax);
+  }
+}
+
+auto LzCompress(std::span<const uint8_t> input) -> std::vector<uint8_t> {
+  CHR_ZONE_SCOPED();
+
+  std::vector<uint8_t> output{};
+  output.reserve(input.size() / 2 + 16);
+
+  debug::Assert(input.size() < std::numeric_limits<uint32_t>::max(),
+                "Input too big for a single LZ block");
+
+  // Last position + 1 of every hashed sequence, 0 means empty.
+  std::vector<uint32_t> table(size_t{1} << kHashBits, 0);
+
+  size_t anchor = 0;
+  size_t position = 0;
+  while (position + kMinMatch <= input.size()) {
+    auto sequence = Load32(input.data() + position);
+    auto& slot = table[HashSequence(sequence)];
+    size_t candidate = slot;
+    slot = static_cast<uint32_t>(position + 1);
+
+    if (candidate == 0 || position - (candidate - 1) > kMaxOffset ||
+        Load32(input.data() + candidate - 1) != sequence) {
+      position++;
+      continue;
+    }
+
+    auto match = candidate - 1;
+    auto length = kMinMatch;
+    while (position + length < input.size() &&
+           input[match + length] == input[position + length]) {
+      length++;
+    }
+
+    WriteSequence(output, input.subspan(anchor, position - anchor),
+                  position - match, length);
+    position += length;
+    anchor = position;
+  }
+
+  WriteSequence(output, input.subspan(anchor), 0, 0);
+  return output;
+}
+
+auto LzDecompress(std::span<const uint8_t> input, std::span<uint8_t> output)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  size_t in = 0;
+  size_t out = 0;
+
+  auto read_length = [&input, &in](size_t length) {
+    if (length != kNibbleMax) {
+      return length;
+    }
+
+    uint8_t value = 0;
+    do {
+      if (in >= input.size()) {
+        throw std::runtime_error("Corrupted compressed data");
+      }
+      value = input[in++];
+      length += value;
+    } while (value == 255);
+    return length;
+  };
+
+  while (in < input.size()) {
+    auto token = input[in++];
+
+    auto literal_length = read_length(token >> 4);
+    if (literal_length > input.size() - in ||
+        literal_length > output.size() - out) {
+      throw std::runtime_error("Corrupted compressed data");
+    }
+    std::memcpy(output.data() + out, input.data() + in, literal_length);
+    in += literal_length;
+    out += literal_length;
+
+    if (in == input.size()) {
+      break;
+    }
+
+    if (input.size() - in < 2) {
+      throw std::runtime_error("Corrupted compressed data");
+    }
+    size_t offset = input[in] | size_t{input[in + 1]} << 8;
+    in += 2;
+
+    auto match_length = read_length(token & kNibbleMax) + kMinMatch;
+    if (offset == 0 || offset > out || match_length > output.size() - out) {
+      throw std::runtime_error("Corrupted compressed data");
+    }
+
+    // Matches can overlap the bytes they produce, in that case they are
+    // copied one byte at a time.
+    if (offset >= match_length) {
+      std::memcpy(output.data() + out, output.data() + out - offset,
+                  match_length);
+      out += match_length;
+    } else {
+      for (size_t i = 0; i < match_length; i++, out++) {
+        output[out] = output[out - offset];
+      }
+    }
+  }
+
+  if (out != output.size()) {
+    throw std::runtime_error("Corrupted compressed data");
+  }
+}
+
+}  // namespace chr::storage::internal
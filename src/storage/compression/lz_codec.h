@@ -0,0 +1,32 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_COMPRESSION_LZ_CODEC_H_
+#define CHR_STORAGE_COMPRESSION_LZ_CODEC_H_
+
+#include <span>
+
+#include "pch.h"
+
+// Byte oriented LZ77 codec, in the spirit of LZ4. The compressed stream is a
+// list of sequences:
+//
+//   token       high nibble literal length, low nibble match length - 4
+//   [uint8_t]   literal length extension, if the nibble is 15
+//   literals
+//   uint16_t    match offset (little endian, 1 to 65535)
+//   [uint8_t]   match length extension, if the nibble is 15
+//
+// Length extensions are a run of 255 terminated by a smaller byte. The last
+// sequence has literals only and ends the stream.
+
+namespace chr::storage::internal {
+
+auto LzCompress(std::span<const uint8_t> input) -> std::vector<uint8_t>;
+auto LzDecompress(std::span<const uint8_t> input, std::span<uint8_t> output)
+    -> void;
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_COMPRESSION_LZ_CODEC_H_
@@ -16,16 +16,20 @@ constexpr size_t kEntrySize = 72;
 struct EntryI : entt::type_list<> {
   template <typename Base>
   struct type : Base {
-    auto Name() const -> std::string { return this->template invoke<0>(*this); }
+    auto Name() const -> std::string_view {
+      return this->template invoke<0>(*this);
+    }
     auto HaveExtension() const -> bool {
       return this->template invoke<1>(*this);
     }
-    auto Extension() const -> std::string {
+    auto Extension() const -> std::string_view {
       return this->template invoke<2>(*this);
     }
     auto IsDirectory() const -> bool { return this->template invoke<3>(*this); }
     auto Size() const -> size_t { return this->template invoke<4>(*this); }
-    auto GetFile() const -> File { return this->template invoke<5>(*this); }
+    auto GetFile(FileMode mode) const -> File {
+      return this->template invoke<5>(*this, mode);
+    }
   };
 
   template <typename Type>
@@ -38,6 +42,8 @@ template <typename T>
 concept ConceptEntry = std::is_base_of_v<EntryI, T>;
 
 struct FilesystemStorage;
+struct MemoryStorage;
+struct PackStorage;
 }  // namespace internal
 
 //! @brief Handle an entry from the storage.
@@ -59,9 +65,12 @@ struct Entry {
     return *this;
   }
 
-  //! @brief Get the entry name.
+  //! @brief Get the entry name. The returned view is owned by the storage
+  //!        backend and it's valid as long as the entry is alive.
   //! @return Entry name.
-  [[nodiscard]] auto Name() const -> std::string { return entry_->Name(); }
+  [[nodiscard]] auto Name() const -> std::string_view {
+    return entry_->Name();
+  }
 
   //! @brief Check if the entry name have an extensions.
   //! @return True if have an extension, otherwise false.
@@ -69,9 +78,10 @@ struct Entry {
     return entry_->HaveExtension();
   }
 
-  //! @brief Get the entry extension.
+  //! @brief Get the entry extension. The returned view is valid as long as
+  //!        the entry is alive.
   //! @return Entry extension.
-  [[nodiscard]] auto Extension() const -> std::string {
+  [[nodiscard]] auto Extension() const -> std::string_view {
     return entry_->Extension();
   }
 
@@ -86,8 +96,12 @@ struct Entry {
   [[nodiscard]] auto Size() const -> size_t { return entry_->Size(); }
 
   //! @brief Get the file object for I/O operations.
+  //! @param mode How the file will be accessed.
   //! @return The file object.
-  [[nodiscard]] auto GetFile() const -> File { return entry_->GetFile(); }
+  [[nodiscard]] auto GetFile(FileMode mode = FileMode::kStream) const
+      -> File {
+    return entry_->GetFile(mode);
+  }
 
  private:
   explicit Entry() = default;
@@ -100,6 +114,8 @@ struct Entry {
   entt::basic_poly<internal::EntryI, internal::kEntrySize> entry_{};
 
   friend struct internal::FilesystemStorage;
+  friend struct internal::MemoryStorage;
+  friend struct internal::PackStorage;
 };
 
 }  // namespace chr::storage
@@ -5,6 +5,9 @@
 #ifndef CHR_STORAGE_FILE_H_
 #define CHR_STORAGE_FILE_H_
 
+#include <memory_resource>
+#include <span>
+
 #include "pch.h"
 
 namespace chr::storage {
@@ -27,18 +30,28 @@ struct FileI : entt::type_list<> {
     auto Read(uint8_t* buffer, size_t size) -> void {
       this->template invoke<5>(*this, buffer, size);
     }
+    auto Map() const -> std::span<const uint8_t> {
+      return this->template invoke<6>(*this);
+    }
+    auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void {
+      this->template invoke<7>(*this, offset, buffer, size);
+    }
   };
 
   template <typename Type>
-  using impl = entt::value_list<&Type::Open, &Type::IsOpen, &Type::Close,
-                                &Type::Seek, &Type::Position, &Type::Read>;
+  using impl =
+      entt::value_list<&Type::Open, &Type::IsOpen, &Type::Close, &Type::Seek,
+                       &Type::Position, &Type::Read, &Type::Map,
+                       &Type::ReadAt>;
 };
 
 template <typename T>
 concept ConceptFile = std::is_base_of_v<FileI, T>;
 
 struct FilesystemStorage;
-struct FilesystemEntry;
+struct MemoryStorage;
+struct PackEntry;
+struct PackStorage;
 }  // namespace internal
 
 //! @brief File position seek direction.
@@ -48,6 +61,16 @@ enum class SeekDir {
   kEnd      //!< Seek from the end of the file.
 };
 
+//! @brief How a file is accessed by the storage backend.
+enum class FileMode {
+  kStream,  //!< Regular file reads, every read copies the data.
+  kMapped,  //!< Memory mapped, the content is available through File::Map.
+  kDirect   //!< Unbuffered reads that bypass the page cache (O_DIRECT on
+            //!< Linux), for large assets that are read once. Sequential
+            //!< reads are double buffered. Backends that are not on the
+            //!< local filesystem ignore it.
+};
+
 //! @brief Handle a file from the storage.
 struct File {
   //! @brief The copy constructor is not supported.
@@ -95,26 +118,81 @@ struct File {
     return file_->Read(buffer, size);
   }
 
+  //! @brief Read data at the given offset without moving the file position.
+  //!        Unlike Seek and Read it doesn't share any state between calls, so
+  //!        it's safe to call it concurrently from multiple threads while the
+  //!        file is open.
+  //! @param offset Offset from the beginning of the file.
+  //! @param buffer The buffer where to load read data.
+  //! @param size Size of the data to read.
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void {
+    file_->ReadAt(offset, buffer, size);
+  }
+
+  //! @brief Get a read-only view of the whole file content. The view points
+  //!        directly to the memory mapped by the backend, so no copy or
+  //!        allocation is made. It's valid until the file is closed.
+  //! @return File content, or an empty span if the file is not open or it
+  //!         wasn't requested with FileMode::kMapped.
+  [[nodiscard]] auto Map() const -> std::span<const uint8_t> {
+    return file_->Map();
+  }
+
   //! @brief Read all the file content.
   //! @return File content.
   [[nodiscard]] auto ReadAll() -> std::vector<uint8_t> {
-    Seek(0, SeekDir::kEnd);
-    auto end = Position();
-    Seek(0, SeekDir::kBegin);
+    std::vector<uint8_t> buffer(ContentSize());
+    ReadAll(buffer);
+    return buffer;
+  }
+
+  //! @brief Read all the file content in memory allocated from a memory
+  //!        resource. With an arena (ex. std::pmr::monotonic_buffer_resource)
+  //!        the files of a whole level can be released at once.
+  //! @param resource Memory resource for the content.
+  //! @return File content.
+  [[nodiscard]] auto ReadAll(std::pmr::memory_resource* resource)
+      -> std::pmr::vector<uint8_t> {
+    std::pmr::vector<uint8_t> buffer(ContentSize(), resource);
+    ReadAll(buffer);
+    return buffer;
+  }
 
-    auto size = end - Position();
-    if (size == 0) {
-      return {};
+  //! @brief Read all the file content in a buffer owned by the caller,
+  //!        without allocating memory.
+  //!        An exception is thrown if the buffer is smaller than the file.
+  //! @param buffer Destination buffer.
+  //! @return Number of bytes read, the file size.
+  auto ReadAll(std::span<uint8_t> buffer) -> size_t {
+    auto size = ContentSize();
+    if (buffer.size() < size) {
+      throw std::length_error("Buffer too small for the file content");
     }
 
-    std::vector<uint8_t> buffer(size);
-    Read(buffer.data(), buffer.size());
-    return buffer;
+    if (auto data = Map(); !data.empty()) {
+      std::ranges::copy(data, buffer.begin());
+    } else if (size > 0) {
+      Read(buffer.data(), size);
+    }
+
+    return size;
   }
 
  private:
   explicit File() = default;
 
+  // Size of the content, the position is moved to the beginning.
+  auto ContentSize() -> size_t {
+    if (auto data = Map(); !data.empty()) {
+      return data.size();
+    }
+
+    Seek(0, SeekDir::kEnd);
+    auto end = Position();
+    Seek(0, SeekDir::kBegin);
+    return end;
+  }
+
   template <internal::ConceptFile Type, typename... Args>
   auto Emplace(Args&&... args) -> void {
     file_.emplace<Type>(std::forward<Args>(args)...);
@@ -123,7 +201,9 @@ struct File {
   entt::basic_poly<internal::FileI, internal::kFileSize> file_{};
 
   friend struct internal::FilesystemStorage;
-  friend struct internal::FilesystemEntry;
+  friend struct internal::MemoryStorage;
+  friend struct internal::PackEntry;
+  friend struct internal::PackStorage;
 };
 
 }  // namespace chr::storage
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "file_cursor.h"
+
+#include <cstring>
+#include <ios>
+
+namespace chr::storage::internal {
+
+auto FileCursor::Seek(size_t file_size, size_t offset, SeekDir direction)
+    -> void {
+  // Offsets are unsigned, like for the standard streams a negative offset
+  // wraps around and moves the cursor backward.
+  switch (direction) {
+    case SeekDir::kBegin:
+      position_ = offset;
+      break;
+    case SeekDir::kCurrent:
+      position_ += offset;
+      break;
+    case SeekDir::kEnd:
+      position_ = file_size + offset;
+      break;
+    default:
+      debug::Assert(false, "Invalid SeekDir value");
+      break;
+  }
+
+  if (position_ > file_size) {
+    throw std::ios_base::failure("Seek out of file bounds");
+  }
+}
+
+auto FileCursor::ReadAt(std::span<const uint8_t> data, size_t offset,
+                        uint8_t* buffer, size_t size) -> void {
+  if (offset > data.size() || size > data.size() - offset) {
+    throw std::ios_base::failure("Read past the end of file");
+  }
+
+  std::memcpy(buffer, data.data() + offset, size);
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,34 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILE_CURSOR_H_
+#define CHR_STORAGE_FILE_CURSOR_H_
+
+#include "file.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct FileCursor {
+  auto Seek(size_t file_size, size_t offset, SeekDir direction) -> void;
+  auto Position() const -> size_t { return position_; }
+  auto Advance(size_t size) -> void { position_ += size; }
+  auto Reset() -> void { position_ = 0; }
+
+  auto Read(std::span<const uint8_t> data, uint8_t* buffer, size_t size)
+      -> void {
+    ReadAt(data, position_, buffer, size);
+    position_ += size;
+  }
+
+  static auto ReadAt(std::span<const uint8_t> data, size_t offset,
+                     uint8_t* buffer, size_t size) -> void;
+
+ private:
+  size_t position_{0};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILE_CURSOR_H_
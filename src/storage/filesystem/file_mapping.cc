@@ -0,0 +1,138 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "file_mapping.h"
+
+#include <system_error>
+
+#if defined(CHR_PLATFORM_WINDOWS)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chr::storage::internal {
+
+#if defined(CHR_PLATFORM_WINDOWS)
+
+FileMapping::FileMapping(const std::filesystem::path& path) {
+  CHR_ZONE_SCOPED();
+
+  file_handle_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  if (file_handle_ == INVALID_HANDLE_VALUE) {
+    file_handle_ = nullptr;
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(), "Failed to open file");
+  }
+
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(file_handle_, &file_size)) {
+    auto error = GetLastError();
+    CloseHandle(file_handle_);
+    throw std::system_error(static_cast<int>(error), std::system_category(),
+                            "Failed to get file size");
+  }
+
+  size_ = static_cast<size_t>(file_size.QuadPart);
+
+  // Empty files can't be mapped, just expose an empty view.
+  if (size_ == 0) {
+    return;
+  }
+
+  mapping_handle_ =
+      CreateFileMappingW(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_handle_ == nullptr) {
+    auto error = GetLastError();
+    CloseHandle(file_handle_);
+    throw std::system_error(static_cast<int>(error), std::system_category(),
+                            "Failed to create file mapping");
+  }
+
+  data_ = static_cast<const uint8_t*>(
+      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    auto error = GetLastError();
+    CloseHandle(mapping_handle_);
+    CloseHandle(file_handle_);
+    throw std::system_error(static_cast<int>(error), std::system_category(),
+                            "Failed to map file");
+  }
+}
+
+FileMapping::~FileMapping() {
+  CHR_ZONE_SCOPED();
+
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+
+  if (mapping_handle_ != nullptr) {
+    CloseHandle(mapping_handle_);
+  }
+
+  if (file_handle_ != nullptr) {
+    CloseHandle(file_handle_);
+  }
+}
+
+#else
+
+FileMapping::FileMapping(const std::filesystem::path& path) {
+  CHR_ZONE_SCOPED();
+
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file");
+  }
+
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) == -1) {
+    auto error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(),
+                            "Failed to get file size");
+  }
+
+  size_ = static_cast<size_t>(file_stat.st_size);
+
+  // Empty files can't be mapped, just expose an empty view.
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+
+  auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  auto error = errno;
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(),
+                            "Failed to map file");
+  }
+
+  data_ = static_cast<const uint8_t*>(data);
+}
+
+FileMapping::~FileMapping() {
+  CHR_ZONE_SCOPED();
+
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+#endif
+
+}  // namespace chr::storage::internal
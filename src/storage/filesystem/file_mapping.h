@@ -0,0 +1,40 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILESYSTEM_FILE_MAPPING_H_
+#define CHR_STORAGE_FILESYSTEM_FILE_MAPPING_H_
+
+#include <filesystem>
+#include <span>
+
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct FileMapping {
+  explicit FileMapping(const std::filesystem::path& path);
+
+  FileMapping(const FileMapping&) = delete;
+  FileMapping(FileMapping&& other) noexcept = delete;
+
+  ~FileMapping();
+
+  FileMapping& operator=(const FileMapping&) = delete;
+  FileMapping& operator=(FileMapping&& other) noexcept = delete;
+
+  auto Data() const -> std::span<const uint8_t> { return {data_, size_}; }
+
+ private:
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+
+#if defined(CHR_PLATFORM_WINDOWS)
+  void* file_handle_{nullptr};
+  void* mapping_handle_{nullptr};
+#endif
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILESYSTEM_FILE_MAPPING_H_
@@ -0,0 +1,207 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "filesystem_direct_file.h"
+
+#include <cstring>
+#include <ios>
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(FilesystemDirectFile) <= kFileSize);
+
+// Size of the staging buffers, big enough to keep the device busy.
+constexpr size_t kDirectBlockSize = 1024 * 1024;
+
+// Worker threads that read the next blocks, shared by all the files.
+constexpr size_t kPrefetchThreadCount = 2;
+
+static auto GetThreadPool() -> utils::ThreadPool& {
+  static utils::ThreadPool thread_pool{kPrefetchThreadCount};
+  return thread_pool;
+}
+
+static auto AllocateAligned(size_t size) -> AlignedBuffer {
+  return AlignedBuffer{static_cast<uint8_t*>(
+      ::operator new[](size, std::align_val_t{kDirectAlignment}))};
+}
+
+static auto AlignDown(size_t offset) -> size_t {
+  return offset / kDirectAlignment * kDirectAlignment;
+}
+
+static auto AlignUp(size_t offset) -> size_t {
+  return AlignDown(offset + kDirectAlignment - 1);
+}
+
+auto FilesystemDirectFile::Open() -> void {
+  CHR_ZONE_SCOPED();
+
+  Close();
+
+  file_ = std::make_unique<NativeFile>();
+  file_->OpenDirect(path_);
+  cursor_.Reset();
+  probe_.RecordOpen();
+}
+
+auto FilesystemDirectFile::Close() -> void {
+  CHR_ZONE_SCOPED();
+
+  // The background read writes into the staging buffer.
+  if (next_.pending.valid()) {
+    next_.pending.wait();
+    next_.pending = {};
+  }
+
+  current_.size = 0;
+  next_.size = 0;
+  file_.reset();
+  cursor_.Reset();
+}
+
+auto FilesystemDirectFile::Read(uint8_t* buffer, size_t size) -> void {
+  CHR_ZONE_SCOPED();
+
+  if (!IsOpen()) {
+    throw std::ios_base::failure("File is not open");
+  }
+
+  probe_.Read(size, [&] {
+    auto position = cursor_.Position();
+    auto* destination = buffer;
+    auto remaining = size;
+    while (remaining > 0) {
+      const auto& block = GetBlock(position);
+      auto block_offset = position - block.offset;
+      if (block_offset >= block.size) {
+        throw std::ios_base::failure("Read past the end of file");
+      }
+
+      auto count = std::min(remaining, block.size - block_offset);
+      std::memcpy(destination, block.data.get() + block_offset, count);
+      destination += count;
+      remaining -= count;
+      position += count;
+    }
+  });
+
+  cursor_.Advance(size);
+}
+
+auto FilesystemDirectFile::ReadAt(size_t offset, uint8_t* buffer,
+                                  size_t size) const -> void {
+  CHR_ZONE_SCOPED();
+
+  if (!IsOpen()) {
+    throw std::ios_base::failure("File is not open");
+  }
+
+  if (size == 0) {
+    return;
+  }
+
+  // Positional reads can be concurrent, so they don't use the staging
+  // buffers of the sequential reads. The range is read through a staging
+  // buffer of at most one block.
+  probe_.Read(size, [&] {
+    auto position = AlignDown(offset);
+    auto end = AlignUp(offset + size);
+    auto staging_size = std::min(end - position, kDirectBlockSize);
+    auto staging = AllocateAligned(staging_size);
+    auto* destination = buffer;
+    auto remaining = size;
+    while (remaining > 0) {
+      // A short read is retried, an unaligned one means the end of the file.
+      auto chunk = std::min(end - position, staging_size);
+      size_t done = 0;
+      while (done < chunk) {
+        auto count = file_->ReadSome(position + done, staging.get() + done,
+                                     chunk - done);
+        if (count == 0) {
+          break;
+        }
+        done += count;
+        if (done % kDirectAlignment != 0) {
+          break;
+        }
+      }
+
+      auto skip = offset > position ? offset - position : 0;
+      auto count = done > skip ? std::min(remaining, done - skip) : 0;
+      std::memcpy(destination, staging.get() + skip, count);
+      destination += count;
+      remaining -= count;
+      position += chunk;
+      if (remaining > 0 && done < chunk) {
+        throw std::ios_base::failure("Read past the end of file");
+      }
+    }
+  });
+}
+
+auto FilesystemDirectFile::GetBlock(size_t offset) -> const DirectBlock& {
+  auto block_offset = offset / kDirectBlockSize * kDirectBlockSize;
+  if (current_.data != nullptr && current_.offset == block_offset &&
+      current_.size > 0) {
+    return current_;
+  }
+
+  if (next_.pending.valid()) {
+    next_.size = next_.pending.get();
+  }
+
+  if (next_.data != nullptr && next_.offset == block_offset &&
+      next_.size > 0) {
+    std::swap(current_, next_);
+  } else {
+    ReadBlock(current_, block_offset, false);
+  }
+
+  // The next block is read while the current one is consumed, unless the end
+  // of the file is already reached.
+  if (current_.size == kDirectBlockSize) {
+    ReadBlock(next_, block_offset + kDirectBlockSize, true);
+  }
+
+  return current_;
+}
+
+auto FilesystemDirectFile::ReadBlock(DirectBlock& block, size_t offset,
+                                     bool async) const -> void {
+  if (block.data == nullptr) {
+    block.data = AllocateAligned(kDirectBlockSize);
+  }
+
+  block.offset = offset;
+  block.size = 0;
+
+  auto read = [file = file_.get(), data = block.data.get(), offset] {
+    CHR_ZONE_SCOPED();
+
+    // A short read means the end of the file, the rest of the block is read
+    // until the device returns nothing.
+    size_t done = 0;
+    while (done < kDirectBlockSize) {
+      auto count = file->ReadSome(offset + done, data + done,
+                                  kDirectBlockSize - done);
+      if (count == 0) {
+        break;
+      }
+      done += count;
+      if (done % kDirectAlignment != 0) {
+        break;
+      }
+    }
+    return done;
+  };
+
+  if (async) {
+    block.pending = GetThreadPool().Submit(read);
+  } else {
+    block.size = read();
+  }
+}
+
+}  // namespace chr::storage::internal
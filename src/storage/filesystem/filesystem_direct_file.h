@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILESYSTEM_FILESYSTEM_DIRECT_FILE_H_
+#define CHR_STORAGE_FILESYSTEM_FILESYSTEM_DIRECT_FILE_H_
+
+#include <filesystem>
+#include <future>
+
+#include "file.h"
+#include "file_cursor.h"
+#include "native_file.h"
+#include "pch.h"
+#include "stats/io_stats_recorder.h"
+
+namespace chr::storage::internal {
+
+struct AlignedDeleter {
+  auto operator()(uint8_t* data) const -> void {
+    ::operator delete[](data, std::align_val_t{kDirectAlignment});
+  }
+};
+
+using AlignedBuffer = std::unique_ptr<uint8_t[], AlignedDeleter>;
+
+// Block of the file held in an aligned staging buffer.
+struct DirectBlock {
+  AlignedBuffer data{};
+  size_t offset{0};
+  size_t size{0};
+  std::future<size_t> pending{};
+};
+
+// File read without the page cache (O_DIRECT). Sequential reads go through
+// two staging buffers, the next block is read in background while the
+// current one is consumed.
+struct FilesystemDirectFile : FileI {
+  explicit FilesystemDirectFile(std::string_view path, IoStatsProbe probe)
+      : path_{path}, probe_{std::move(probe)} {};
+
+  FilesystemDirectFile(const FilesystemDirectFile&) = delete;
+  FilesystemDirectFile(FilesystemDirectFile&& other) noexcept
+      : path_{std::move(other.path_)},
+        probe_{std::move(other.probe_)},
+        file_{std::move(other.file_)},
+        cursor_{other.cursor_},
+        current_{std::move(other.current_)},
+        next_{std::move(other.next_)} {}
+
+  ~FilesystemDirectFile() { Close(); }
+
+  FilesystemDirectFile& operator=(const FilesystemDirectFile&) = delete;
+  FilesystemDirectFile& operator=(FilesystemDirectFile&& other) noexcept =
+      delete;
+
+  auto Open() -> void;
+  auto IsOpen() const -> bool { return file_ != nullptr && file_->IsOpen(); }
+  auto Close() -> void;
+  auto Seek(size_t offset, SeekDir direction) -> void {
+    probe_.RecordSeek();
+    cursor_.Seek(IsOpen() ? file_->Size() : 0, offset, direction);
+  }
+  auto Position() -> size_t { return cursor_.Position(); }
+  auto Read(uint8_t* buffer, size_t size) -> void;
+  auto Map() const -> std::span<const uint8_t> { return {}; }
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void;
+
+ private:
+  auto GetBlock(size_t offset) -> const DirectBlock&;
+  auto ReadBlock(DirectBlock& block, size_t offset, bool async) const -> void;
+
+  std::filesystem::path path_;
+  IoStatsProbe probe_;
+
+  // Heap allocated, so the background reads don't depend on the address of
+  // this object.
+  std::unique_ptr<NativeFile> file_{};
+  FileCursor cursor_{};
+  DirectBlock current_{};
+  DirectBlock next_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_DIRECT_FILE_H_
@@ -4,8 +4,17 @@
 
 #include "filesystem_entry.h"
 
+#include "filesystem_storage.h"
+
 namespace chr::storage::internal {
 
 static_assert(sizeof(FilesystemEntry) <= kEntrySize);
 
+auto FilesystemEntry::GetFile(FileMode mode) const -> File {
+  return FilesystemStorage::OpenFile(
+      index_->GetNativePath(node_->path), mode,
+      {.recorder = stats_, .prefix = stats_->GetCounters(node_->path)},
+      cache_);
+}
+
 }  // namespace chr::storage::internal
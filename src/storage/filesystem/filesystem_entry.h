@@ -5,52 +5,55 @@
 #ifndef CHR_STORAGE_FILESYSTEM_FILESYSTEM_ENTRY_H_
 #define CHR_STORAGE_FILESYSTEM_FILESYSTEM_ENTRY_H_
 
-#include <filesystem>
-#include <fstream>
-
+#include "block_cache.h"
 #include "entry.h"
-#include "filesystem_file.h"
+#include "path_index.h"
 #include "pch.h"
+#include "stats/io_stats_recorder.h"
 
 namespace chr::storage::internal {
 
 struct FilesystemEntry : EntryI {
-  explicit FilesystemEntry(const std::filesystem::directory_entry& dir_entry)
-      : dir_entry_{dir_entry} {};
+  explicit FilesystemEntry(std::shared_ptr<const PathIndex> index,
+                           std::shared_ptr<IoStatsRecorder> stats,
+                           std::shared_ptr<BlockCache> cache,
+                           const PathIndexNode* node)
+      : index_{std::move(index)},
+        stats_{std::move(stats)},
+        cache_{std::move(cache)},
+        node_{node} {};
 
   FilesystemEntry(const FilesystemEntry&) = delete;
   FilesystemEntry(FilesystemEntry&& other) noexcept
-      : dir_entry_{std::move(other.dir_entry_)} {}
+      : index_{std::move(other.index_)},
+        stats_{std::move(other.stats_)},
+        cache_{std::move(other.cache_)},
+        node_{other.node_} {}
 
   FilesystemEntry& operator=(const FilesystemEntry&) = delete;
   FilesystemEntry& operator=(FilesystemEntry&& other) noexcept = delete;
 
-  auto Name() const -> std::string {
-    return dir_entry_.path().filename().string();
-  };
+  auto Name() const -> std::string_view { return PathName(node_->path); };
 
-  auto HaveExtension() const -> bool {
-    return dir_entry_.path().has_extension();
-  }
+  auto HaveExtension() const -> bool { return !Extension().empty(); }
 
-  auto Extension() const -> std::string {
-    return dir_entry_.path().extension().string();
+  auto Extension() const -> std::string_view {
+    return PathExtension(Name());
   };
 
-  auto IsDirectory() const -> bool { return dir_entry_.is_directory(); }
+  auto IsDirectory() const -> bool { return node_->is_directory; }
 
-  auto Size() const -> size_t { return dir_entry_.file_size(); }
+  auto Size() const -> size_t { return node_->size; }
 
-  auto GetFile() const -> File {
-    File file{};
-    file.Emplace<FilesystemFile>(dir_entry_.path().string());
-    return file;
-  }
+  auto GetFile(FileMode mode) const -> File;
 
  private:
-  std::filesystem::directory_entry dir_entry_;
+  std::shared_ptr<const PathIndex> index_;
+  std::shared_ptr<IoStatsRecorder> stats_;
+  std::shared_ptr<BlockCache> cache_;
+  const PathIndexNode* node_;
 };
 
 }  // namespace chr::storage::internal
 
-#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_ENTRY_H_
\ No newline at end of file
+#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_ENTRY_H_
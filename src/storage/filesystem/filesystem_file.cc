@@ -4,29 +4,87 @@
 
 #include "filesystem_file.h"
 
+#include <ios>
+
 namespace chr::storage::internal {
 
 static_assert(sizeof(FilesystemFile) <= kFileSize);
 
-constexpr auto GetStdSeekDir(SeekDir direction) -> std::ios_base::seekdir {
-  switch (direction) {
-    case SeekDir::kBegin:
-      return std::ios::beg;
-    case SeekDir::kCurrent:
-      return std::ios::cur;
-    case SeekDir::kEnd:
-      return std::ios::end;
-    default:
-      break;
+auto FilesystemFile::Open() -> void {
+  CHR_ZONE_SCOPED();
+
+  file_.Open(path_);
+  if (cache_ != nullptr) {
+    file_id_ = file_.Identity();
   }
+  cursor_.Reset();
+  probe_.RecordOpen();
+}
+
+auto FilesystemFile::Close() -> void {
+  CHR_ZONE_SCOPED();
+
+  file_.Close();
+  cursor_.Reset();
+}
+
+auto FilesystemFile::Read(uint8_t* buffer, size_t size) -> void {
+  // Sequential reads are positional reads at the cursor, the descriptor
+  // offset is never used.
+  ReadAt(cursor_.Position(), buffer, size);
+  cursor_.Advance(size);
+}
+
+auto FilesystemFile::ReadAt(size_t offset, uint8_t* buffer, size_t size) const
+    -> void {
+  CHR_ZONE_SCOPED();
 
-  debug::Assert(false, "Invalid SeekDir value");
+  // Only the small reads go through the cache, the big ones would evict
+  // many blocks that are not read again.
+  if (cache_ != nullptr && size < cache_->BlockSize()) {
+    ReadCached(offset, buffer, size);
+    return;
+  }
 
-  return std::ios::beg;
+  probe_.Read(size, [&] { file_.ReadAt(offset, buffer, size); });
 }
 
-auto FilesystemFile::Seek(size_t offset, SeekDir direction) -> void {
-  file_.seekg(offset, GetStdSeekDir(direction));
+auto FilesystemFile::ReadCached(size_t offset, uint8_t* buffer,
+                                size_t size) const -> void {
+  auto block_size = cache_->BlockSize();
+  while (size > 0) {
+    auto block = offset / block_size;
+    auto block_offset = offset % block_size;
+    auto chunk = std::min(size, block_size - block_offset);
+    if (!cache_->Read(file_id_, block, block_offset, buffer, chunk)) {
+      // The whole block is loaded, the last block of the file is shorter.
+      std::vector<uint8_t> data(block_size);
+      auto read = probe_.ReadSome([&] {
+        size_t done = 0;
+        while (done < block_size) {
+          auto count = file_.ReadSome(block * block_size + done,
+                                      data.data() + done, block_size - done);
+          if (count == 0) {
+            break;
+          }
+          done += count;
+        }
+        return done;
+      });
+
+      if (block_offset + chunk > read) {
+        throw std::ios_base::failure("Read past the end of file");
+      }
+
+      data.resize(read);
+      std::memcpy(buffer, data.data() + block_offset, chunk);
+      cache_->Insert(file_id_, block, std::move(data));
+    }
+
+    offset += chunk;
+    buffer += chunk;
+    size -= chunk;
+  }
 }
 
 }  // namespace chr::storage::internal
@@ -6,47 +6,56 @@
 #define CHR_STORAGE_FILESYSTEM_FILESYSTEM_FILE_H_
 
 #include <filesystem>
-#include <fstream>
 
+#include "block_cache.h"
 #include "file.h"
+#include "file_cursor.h"
+#include "native_file.h"
 #include "pch.h"
+#include "stats/io_stats_recorder.h"
 
 namespace chr::storage::internal {
 
 struct FilesystemFile : FileI {
-  explicit FilesystemFile(std::string_view path) : path_{path} {
-    file_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-  };
+  explicit FilesystemFile(std::string_view path, IoStatsProbe probe,
+                          std::shared_ptr<BlockCache> cache)
+      : path_{path}, probe_{std::move(probe)}, cache_{std::move(cache)} {};
 
   FilesystemFile(const FilesystemFile&) = delete;
   FilesystemFile(FilesystemFile&& other) noexcept
-      : path_{std::move(other.path_)}, file_{std::move(other.file_)} {}
-
-  ~FilesystemFile() {
-    if (IsOpen()) {
-      try {
-        Close();
-      } catch (std::exception e) {
-        log::Err("{}", e.what());
-      }
-    }
-  }
+      : path_{std::move(other.path_)},
+        probe_{std::move(other.probe_)},
+        cache_{std::move(other.cache_)},
+        file_{std::move(other.file_)},
+        file_id_{other.file_id_},
+        cursor_{other.cursor_} {}
 
   FilesystemFile& operator=(const FilesystemFile&) = delete;
   FilesystemFile& operator=(FilesystemFile&& other) noexcept = delete;
 
-  auto Open() -> void { file_.open(path_, std::ios::binary | std::ios::ate); }
-  auto IsOpen() const -> bool { return file_.is_open(); }
-  auto Close() -> void { file_.close(); }
-  auto Seek(size_t offset, SeekDir direction) -> void;
-  auto Position() -> size_t { return file_.tellg(); }
-  auto Read(uint8_t* buffer, size_t size) -> void { file_.read(buffer, size); }
+  auto Open() -> void;
+  auto IsOpen() const -> bool { return file_.IsOpen(); }
+  auto Close() -> void;
+  auto Seek(size_t offset, SeekDir direction) -> void {
+    probe_.RecordSeek();
+    cursor_.Seek(file_.Size(), offset, direction);
+  }
+  auto Position() -> size_t { return cursor_.Position(); }
+  auto Read(uint8_t* buffer, size_t size) -> void;
+  auto Map() const -> std::span<const uint8_t> { return {}; }
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void;
 
  private:
+  auto ReadCached(size_t offset, uint8_t* buffer, size_t size) const -> void;
+
   std::filesystem::path path_;
-  std::basic_ifstream<uint8_t> file_{};
+  IoStatsProbe probe_;
+  std::shared_ptr<BlockCache> cache_;
+  NativeFile file_{};
+  uint64_t file_id_{0};
+  FileCursor cursor_{};
 };
 
 }  // namespace chr::storage::internal
 
-#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_FILE_H_
\ No newline at end of file
+#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_FILE_H_
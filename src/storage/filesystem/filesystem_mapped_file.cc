@@ -0,0 +1,34 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "filesystem_mapped_file.h"
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(FilesystemMappedFile) <= kFileSize);
+
+auto FilesystemMappedFile::Open() -> void {
+  CHR_ZONE_SCOPED();
+
+  mapping_ = std::make_unique<FileMapping>(path_);
+  cursor_.Reset();
+  probe_.RecordOpen();
+}
+
+auto FilesystemMappedFile::Close() -> void {
+  CHR_ZONE_SCOPED();
+
+  mapping_.reset();
+  cursor_.Reset();
+}
+
+auto FilesystemMappedFile::Map() const -> std::span<const uint8_t> {
+  if (mapping_ == nullptr) {
+    return {};
+  }
+
+  return mapping_->Data();
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILESYSTEM_FILESYSTEM_MAPPED_FILE_H_
+#define CHR_STORAGE_FILESYSTEM_FILESYSTEM_MAPPED_FILE_H_
+
+#include <filesystem>
+
+#include "file.h"
+#include "file_cursor.h"
+#include "file_mapping.h"
+#include "pch.h"
+#include "stats/io_stats_recorder.h"
+
+namespace chr::storage::internal {
+
+struct FilesystemMappedFile : FileI {
+  explicit FilesystemMappedFile(std::string_view path, IoStatsProbe probe)
+      : path_{path}, probe_{std::move(probe)} {};
+
+  FilesystemMappedFile(const FilesystemMappedFile&) = delete;
+  FilesystemMappedFile(FilesystemMappedFile&& other) noexcept
+      : path_{std::move(other.path_)},
+        probe_{std::move(other.probe_)},
+        mapping_{std::move(other.mapping_)},
+        cursor_{other.cursor_} {}
+
+  FilesystemMappedFile& operator=(const FilesystemMappedFile&) = delete;
+  FilesystemMappedFile& operator=(FilesystemMappedFile&& other) noexcept =
+      delete;
+
+  auto Open() -> void;
+  auto IsOpen() const -> bool { return mapping_ != nullptr; }
+  auto Close() -> void;
+  auto Seek(size_t offset, SeekDir direction) -> void {
+    probe_.RecordSeek();
+    cursor_.Seek(Map().size(), offset, direction);
+  }
+  auto Position() -> size_t { return cursor_.Position(); }
+  auto Read(uint8_t* buffer, size_t size) -> void {
+    probe_.Read(size, [&] { cursor_.Read(Map(), buffer, size); });
+  }
+  auto Map() const -> std::span<const uint8_t>;
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void {
+    probe_.Read(size, [&] { FileCursor::ReadAt(Map(), offset, buffer, size); });
+  }
+
+ private:
+  std::filesystem::path path_;
+  IoStatsProbe probe_;
+  std::unique_ptr<FileMapping> mapping_{};
+  FileCursor cursor_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_MAPPED_FILE_H_
@@ -4,8 +4,11 @@
 
 #include "filesystem_storage.h"
 
+#include "filesystem_direct_file.h"
 #include "filesystem_entry.h"
 #include "filesystem_file.h"
+#include "filesystem_mapped_file.h"
+#include "native_file.h"
 
 namespace chr::storage::internal {
 
@@ -13,27 +16,113 @@ static_assert(sizeof(FilesystemStorage) <= kStorageSize);
 
 auto FilesystemStorage::GetEntries(std::string_view path) const
     -> std::vector<Entry> {
-  std::vector<Entry> entries{};
-  std::filesystem::path current_path{base_path_};
-  current_path.concat(path);
+  CHR_ZONE_SCOPED();
+
+  const auto* directory = index_->Find(path);
+  if (directory == nullptr || !directory->is_directory) {
+    throw std::filesystem::filesystem_error(
+        "Directory not found", GetNativePath(path),
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
 
-  for (auto const& dir_entry :
-       std::filesystem::directory_iterator{current_path}) {
+  auto children = index_->GetChildren(*directory);
+
+  std::vector<Entry> entries{};
+  entries.reserve(children.size());
+  for (const auto* child : children) {
     Entry entry{};
-    entry.Emplace<FilesystemEntry>(dir_entry);
+    entry.Emplace<FilesystemEntry>(index_, stats_, cache_, child);
     entries.emplace_back(std::move(entry));
   }
 
   return entries;
 }
 
-auto FilesystemStorage::GetFile(std::string_view path) const -> File {
-  std::filesystem::path current_path{base_path_};
-  current_path.concat(path);
+auto FilesystemStorage::GetFile(std::string_view path, FileMode mode) const
+    -> File {
+  return OpenFile(GetNativePath(path), mode,
+                  {.recorder = stats_, .prefix = stats_->GetCounters(path)},
+                  cache_);
+}
+
+auto FilesystemStorage::GetEntry(std::string_view path) const
+    -> std::optional<Entry> {
+  return MakeEntry(index_->Find(path));
+}
+
+auto FilesystemStorage::GetEntryById(PathId id) const -> std::optional<Entry> {
+  return MakeEntry(index_->Find(id));
+}
+
+auto FilesystemStorage::ReadMany(std::span<const ReadRequest> requests) const
+    -> void {
+  CHR_ZONE_SCOPED();
 
+  // Requests are grouped by file and sorted by offset, so every file is
+  // opened once and contiguous ranges are read with a single system call.
+  std::vector<const ReadRequest*> sorted{};
+  sorted.reserve(requests.size());
+  for (const auto& request : requests) {
+    sorted.push_back(&request);
+  }
+  std::ranges::sort(sorted, [](const auto* lhs, const auto* rhs) {
+    return std::tie(lhs->path, lhs->offset) < std::tie(rhs->path, rhs->offset);
+  });
+
+  NativeFile file{};
+  IoStatsProbe probe{};
+  std::string_view file_path{};
+  std::vector<std::span<uint8_t>> buffers{};
+  for (size_t i = 0; i < sorted.size();) {
+    const auto* first = sorted[i];
+    if (!file.IsOpen() || first->path != file_path) {
+      file.Open(GetNativePath(first->path));
+      file_path = first->path;
+      probe = {.recorder = stats_, .prefix = stats_->GetCounters(file_path)};
+      probe.RecordOpen();
+    }
+
+    buffers.clear();
+    buffers.push_back(first->buffer);
+    auto end = first->offset + first->buffer.size();
+    for (i++; i < sorted.size() && sorted[i]->path == file_path &&
+              sorted[i]->offset == end;
+         i++) {
+      buffers.push_back(sorted[i]->buffer);
+      end += sorted[i]->buffer.size();
+    }
+
+    probe.Read(end - first->offset,
+               [&] { file.ReadAt(first->offset, buffers); });
+  }
+}
+
+auto FilesystemStorage::OpenFile(const std::filesystem::path& path,
+                                 FileMode mode, IoStatsProbe probe,
+                                 std::shared_ptr<BlockCache> cache) -> File {
+  // The mapped and direct files don't use the block cache, the former
+  // already read from the page cache and the latter is meant to bypass it.
   File file{};
-  file.Emplace<FilesystemFile>(current_path.string());
+  if (mode == FileMode::kMapped) {
+    file.Emplace<FilesystemMappedFile>(path.string(), std::move(probe));
+  } else if (mode == FileMode::kDirect) {
+    file.Emplace<FilesystemDirectFile>(path.string(), std::move(probe));
+  } else {
+    file.Emplace<FilesystemFile>(path.string(), std::move(probe),
+                                 std::move(cache));
+  }
   return file;
 }
 
+auto FilesystemStorage::MakeEntry(const PathIndexNode* node) const
+    -> std::optional<Entry> {
+  if (node == nullptr) {
+    return std::nullopt;
+  }
+
+  Entry entry{};
+  entry.Emplace<FilesystemEntry>(index_, stats_, cache_, node);
+  return entry;
+}
+
 }  // namespace chr::storage::internal
@@ -7,30 +7,58 @@
 
 #include <filesystem>
 
+#include "block_cache.h"
+#include "path_index.h"
 #include "pch.h"
+#include "stats/io_stats_recorder.h"
 #include "storage.h"
 
 namespace chr::storage::internal {
 
 struct FilesystemStorage : StorageI {
-  explicit FilesystemStorage() = default;
+  explicit FilesystemStorage()
+      : index_{std::make_shared<PathIndex>(std::filesystem::path{})},
+        stats_{std::make_shared<IoStatsRecorder>()} {}
 
   FilesystemStorage(const FilesystemStorage&) = delete;
   FilesystemStorage(FilesystemStorage&& other) noexcept
-      : base_path_{std::move(other.base_path_)} {}
+      : index_{std::move(other.index_)},
+        stats_{std::move(other.stats_)},
+        cache_{std::move(other.cache_)} {}
 
   FilesystemStorage& operator=(const FilesystemStorage&) = delete;
   FilesystemStorage& operator=(FilesystemStorage&& other) noexcept = delete;
 
-  auto SetBasePath(std::string_view path) -> void { base_path_ = path; }
+  auto SetBasePath(std::string_view path) -> void {
+    index_ = std::make_shared<PathIndex>(std::filesystem::path{path});
+  }
 
   auto GetEntries(std::string_view path) const -> std::vector<Entry>;
-  auto GetFile(std::string_view path) const -> File;
+  auto GetFile(std::string_view path, FileMode mode) const -> File;
+  auto GetNativePath(std::string_view path) const -> std::filesystem::path {
+    return index_->GetNativePath(path);
+  }
+  auto GetEntry(std::string_view path) const -> std::optional<Entry>;
+  auto GetEntryById(PathId id) const -> std::optional<Entry>;
+  auto Refresh(std::string_view path) -> void { index_->Refresh(path); }
+  auto ReadMany(std::span<const ReadRequest> requests) const -> void;
+  auto GetStats() const -> StorageStats { return stats_->GetStats(); }
+  auto SetBlockCache(std::shared_ptr<BlockCache> cache) -> void {
+    cache_ = std::move(cache);
+  }
+
+  static auto OpenFile(const std::filesystem::path& path, FileMode mode,
+                       IoStatsProbe probe, std::shared_ptr<BlockCache> cache)
+      -> File;
 
  private:
-  std::filesystem::path base_path_{};
+  auto MakeEntry(const PathIndexNode* node) const -> std::optional<Entry>;
+
+  std::shared_ptr<PathIndex> index_;
+  std::shared_ptr<IoStatsRecorder> stats_;
+  std::shared_ptr<BlockCache> cache_{};
 };
 
 }  // namespace chr::storage::internal
 
-#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_STORAGE_H_
\ No newline at end of file
+#endif  // CHR_STORAGE_FILESYSTEM_FILESYSTEM_STORAGE_H_
@@ -0,0 +1,336 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "native_file.h"
+
+#include <algorithm>
+#include <ios>
+#include <limits>
+#include <system_error>
+
+#include "hash.h"
+
+#if defined(CHR_PLATFORM_WINDOWS)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <climits>
+#endif
+
+namespace chr::storage::internal {
+
+#if defined(CHR_PLATFORM_WINDOWS)
+
+auto NativeFile::Open(const std::filesystem::path& path) -> void {
+  CHR_ZONE_SCOPED();
+
+  Close();
+
+  auto handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(), "Failed to open file");
+  }
+
+  handle_ = handle;
+}
+
+auto NativeFile::OpenDirect(const std::filesystem::path& path) -> void {
+  CHR_ZONE_SCOPED();
+
+  Close();
+
+  auto handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING,
+                            nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(), "Failed to open file");
+  }
+
+  handle_ = handle;
+}
+
+auto NativeFile::Close() noexcept -> void {
+  if (handle_ != kInvalidHandle) {
+    CloseHandle(handle_);
+    handle_ = kInvalidHandle;
+  }
+}
+
+auto NativeFile::Size() const -> size_t {
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(handle_, &file_size)) {
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(),
+                            "Failed to get file size");
+  }
+
+  return static_cast<size_t>(file_size.QuadPart);
+}
+
+auto NativeFile::Identity() const -> uint64_t {
+  BY_HANDLE_FILE_INFORMATION info{};
+  if (!GetFileInformationByHandle(handle_, &info)) {
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(),
+                            "Failed to get file information");
+  }
+
+  std::array<uint64_t, 4> fields{
+      info.dwVolumeSerialNumber,
+      (uint64_t{info.nFileIndexHigh} << 32) | info.nFileIndexLow,
+      (uint64_t{info.nFileSizeHigh} << 32) | info.nFileSizeLow,
+      (uint64_t{info.ftLastWriteTime.dwHighDateTime} << 32) |
+          info.ftLastWriteTime.dwLowDateTime};
+  return HashContent(
+      {std::bit_cast<const uint8_t*>(fields.data()), sizeof(fields)});
+}
+
+auto NativeFile::ReadAt(size_t offset, uint8_t* buffer, size_t size) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  while (size > 0) {
+    // The offset is carried by the OVERLAPPED structure, so concurrent reads
+    // don't depend on the shared file pointer.
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(uint64_t{offset} >> 32);
+
+    auto to_read = static_cast<DWORD>(
+        std::min<size_t>(size, std::numeric_limits<DWORD>::max()));
+    DWORD read = 0;
+    if (!ReadFile(handle_, buffer, to_read, &read, &overlapped)) {
+      auto error = GetLastError();
+      if (error == ERROR_HANDLE_EOF) {
+        throw std::ios_base::failure("Read past the end of file");
+      }
+      throw std::system_error(static_cast<int>(error), std::system_category(),
+                              "Failed to read file");
+    }
+
+    if (read == 0) {
+      throw std::ios_base::failure("Read past the end of file");
+    }
+
+    offset += read;
+    buffer += read;
+    size -= read;
+  }
+}
+
+auto NativeFile::ReadAt(size_t offset,
+                        std::span<const std::span<uint8_t>> buffers) const
+    -> void {
+  for (auto buffer : buffers) {
+    ReadAt(offset, buffer.data(), buffer.size());
+    offset += buffer.size();
+  }
+}
+
+auto NativeFile::ReadSome(size_t offset, uint8_t* buffer, size_t size) const
+    -> size_t {
+  OVERLAPPED overlapped{};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(uint64_t{offset} >> 32);
+
+  auto to_read = static_cast<DWORD>(
+      std::min<size_t>(size, std::numeric_limits<DWORD>::max()));
+  DWORD read = 0;
+  if (!ReadFile(handle_, buffer, to_read, &read, &overlapped)) {
+    auto error = GetLastError();
+    if (error == ERROR_HANDLE_EOF) {
+      return 0;
+    }
+    throw std::system_error(static_cast<int>(error), std::system_category(),
+                            "Failed to read file");
+  }
+
+  return read;
+}
+
+#else
+
+auto NativeFile::Open(const std::filesystem::path& path) -> void {
+  CHR_ZONE_SCOPED();
+
+  Close();
+
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file");
+  }
+
+  handle_ = fd;
+}
+
+auto NativeFile::OpenDirect(const std::filesystem::path& path) -> void {
+  CHR_ZONE_SCOPED();
+
+  Close();
+
+#if defined(CHR_PLATFORM_LINUX)
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+  if (fd == -1 && errno == EINVAL) {
+    // The filesystem doesn't support O_DIRECT (ex. tmpfs), the reads are
+    // buffered but the kernel is told that the data is not reused.
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_NOREUSE);
+    }
+  }
+#else
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#if defined(CHR_PLATFORM_MACOS)
+  if (fd != -1) {
+    fcntl(fd, F_NOCACHE, 1);
+  }
+#endif
+#endif
+
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file");
+  }
+
+  handle_ = fd;
+}
+
+auto NativeFile::Close() noexcept -> void {
+  if (handle_ != kInvalidHandle) {
+    close(handle_);
+    handle_ = kInvalidHandle;
+  }
+}
+
+auto NativeFile::Size() const -> size_t {
+  struct stat file_stat {};
+  if (fstat(handle_, &file_stat) == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to get file size");
+  }
+
+  return static_cast<size_t>(file_stat.st_size);
+}
+
+auto NativeFile::Identity() const -> uint64_t {
+  struct stat file_stat {};
+  if (fstat(handle_, &file_stat) == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to get file information");
+  }
+
+#if defined(CHR_PLATFORM_MACOS)
+  const auto& modified = file_stat.st_mtimespec;
+#else
+  const auto& modified = file_stat.st_mtim;
+#endif
+  std::array<uint64_t, 5> fields{static_cast<uint64_t>(file_stat.st_dev),
+                                 static_cast<uint64_t>(file_stat.st_ino),
+                                 static_cast<uint64_t>(file_stat.st_size),
+                                 static_cast<uint64_t>(modified.tv_sec),
+                                 static_cast<uint64_t>(modified.tv_nsec)};
+  return HashContent(
+      {std::bit_cast<const uint8_t*>(fields.data()), sizeof(fields)});
+}
+
+auto NativeFile::ReadAt(size_t offset, uint8_t* buffer, size_t size) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  while (size > 0) {
+    auto read = pread(handle_, buffer, size, static_cast<off_t>(offset));
+    if (read == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "Failed to read file");
+    }
+
+    if (read == 0) {
+      throw std::ios_base::failure("Read past the end of file");
+    }
+
+    offset += static_cast<size_t>(read);
+    buffer += read;
+    size -= static_cast<size_t>(read);
+  }
+}
+
+auto NativeFile::ReadSome(size_t offset, uint8_t* buffer, size_t size) const
+    -> size_t {
+  while (true) {
+    auto read = pread(handle_, buffer, size, static_cast<off_t>(offset));
+    if (read != -1) {
+      return static_cast<size_t>(read);
+    }
+
+    if (errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(),
+                              "Failed to read file");
+    }
+  }
+}
+
+auto NativeFile::ReadAt(size_t offset,
+                        std::span<const std::span<uint8_t>> buffers) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  std::vector<iovec> vectors{};
+  vectors.reserve(buffers.size());
+  for (auto buffer : buffers) {
+    if (!buffer.empty()) {
+      vectors.push_back({.iov_base = buffer.data(), .iov_len = buffer.size()});
+    }
+  }
+
+  size_t index = 0;
+  while (index < vectors.size()) {
+    auto count = std::min<size_t>(vectors.size() - index, IOV_MAX);
+    auto read = preadv(handle_, &vectors[index], static_cast<int>(count),
+                       static_cast<off_t>(offset));
+    if (read == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "Failed to read file");
+    }
+
+    if (read == 0) {
+      throw std::ios_base::failure("Read past the end of file");
+    }
+
+    offset += static_cast<size_t>(read);
+
+    // Skip the filled buffers and resume from the partially filled one.
+    auto remaining = static_cast<size_t>(read);
+    while (index < vectors.size() && remaining >= vectors[index].iov_len) {
+      remaining -= vectors[index].iov_len;
+      index++;
+    }
+
+    if (remaining > 0) {
+      vectors[index].iov_base =
+          static_cast<uint8_t*>(vectors[index].iov_base) + remaining;
+      vectors[index].iov_len -= remaining;
+    }
+  }
+}
+
+#endif
+
+}  // namespace chr::storage::internal
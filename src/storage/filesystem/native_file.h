@@ -0,0 +1,69 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILESYSTEM_NATIVE_FILE_H_
+#define CHR_STORAGE_FILESYSTEM_NATIVE_FILE_H_
+
+#include <filesystem>
+#include <span>
+
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+// Alignment required by the unbuffered reads, it's the page size and a
+// multiple of the sector size of the common devices.
+constexpr size_t kDirectAlignment = 4096;
+
+struct NativeFile {
+  NativeFile() = default;
+
+  NativeFile(const NativeFile&) = delete;
+  NativeFile(NativeFile&& other) noexcept
+      : handle_{std::exchange(other.handle_, kInvalidHandle)} {}
+
+  ~NativeFile() { Close(); }
+
+  NativeFile& operator=(const NativeFile&) = delete;
+  NativeFile& operator=(NativeFile&& other) noexcept = delete;
+
+  auto Open(const std::filesystem::path& path) -> void;
+
+  // Open the file for unbuffered reads that bypass the page cache. Offsets,
+  // sizes and buffers of the reads must be aligned to kDirectAlignment.
+  auto OpenDirect(const std::filesystem::path& path) -> void;
+  auto IsOpen() const -> bool { return handle_ != kInvalidHandle; }
+  auto Close() noexcept -> void;
+  auto Size() const -> size_t;
+
+  // Identifier of the file content, it changes when the file is modified
+  // (it's derived from the file id, the size and the modification time).
+  auto Identity() const -> uint64_t;
+
+  // Positional read, it doesn't share any state between calls so it's safe
+  // to call it concurrently from multiple threads.
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void;
+
+  // Single positional read, it returns the number of bytes read that is
+  // smaller than size at the end of the file.
+  auto ReadSome(size_t offset, uint8_t* buffer, size_t size) const -> size_t;
+
+  // Positional read of contiguous data into many buffers, with a single
+  // system call where it's supported.
+  auto ReadAt(size_t offset, std::span<const std::span<uint8_t>> buffers) const
+      -> void;
+
+ private:
+#if defined(CHR_PLATFORM_WINDOWS)
+  static constexpr void* kInvalidHandle = nullptr;
+  void* handle_{kInvalidHandle};
+#else
+  static constexpr int kInvalidHandle = -1;
+  int handle_{kInvalidHandle};
+#endif
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILESYSTEM_NATIVE_FILE_H_
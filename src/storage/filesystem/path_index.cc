@@ -0,0 +1,226 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "path_index.h"
+
+#include <mutex>
+
+namespace chr::storage::internal {
+
+PathIndex::PathIndex(std::filesystem::path base_path)
+    : base_path_{std::move(base_path)} {
+  std::error_code error{};
+  auto& root = nodes_.emplace_back();
+  root.path = "/";
+  root.is_directory = std::filesystem::is_directory(GetNativePath("/"), error);
+  ids_.emplace(HashPath(root.path), &root);
+}
+
+auto PathIndex::Find(std::string_view path) -> const PathIndexNode* {
+  CHR_ZONE_SCOPED();
+
+  auto id = HashPath(path);
+  {
+    std::shared_lock lock{mutex_};
+    if (auto* node = Lookup(id, path); node != nullptr || is_fully_scanned_) {
+      return node;
+    }
+  }
+
+  auto normalized = NormalizePath(path);
+
+  std::unique_lock lock{mutex_};
+  return FindOrScan(normalized);
+}
+
+auto PathIndex::Find(PathId id) -> const PathIndexNode* {
+  CHR_ZONE_SCOPED();
+
+  {
+    std::shared_lock lock{mutex_};
+    if (auto it = ids_.find(id); it != ids_.end()) {
+      return it->second;
+    }
+
+    if (is_fully_scanned_) {
+      return nullptr;
+    }
+  }
+
+  // A hash can't be turned back into a path, so the only way to resolve an
+  // unknown identifier is to index the whole tree.
+  std::unique_lock lock{mutex_};
+  ScanAll();
+
+  auto it = ids_.find(id);
+  return it != ids_.end() ? it->second : nullptr;
+}
+
+auto PathIndex::GetChildren(const PathIndexNode& node)
+    -> std::span<const PathIndexNode* const> {
+  CHR_ZONE_SCOPED();
+
+  {
+    std::shared_lock lock{mutex_};
+    if (node.is_scanned || !node.is_directory) {
+      return node.children;
+    }
+  }
+
+  std::unique_lock lock{mutex_};
+  auto& mutable_node = *ids_.at(HashPath(node.path));
+  if (!mutable_node.is_scanned) {
+    Scan(mutable_node);
+  }
+
+  return mutable_node.children;
+}
+
+auto PathIndex::GetNativePath(std::string_view path) const
+    -> std::filesystem::path {
+  std::filesystem::path native_path{base_path_};
+  native_path.concat(path);
+  return native_path;
+}
+
+auto PathIndex::Refresh(std::string_view path) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto normalized = NormalizePath(path);
+
+  std::unique_lock lock{mutex_};
+
+  // The parent directory is listed again the next time it's requested, so the
+  // path is added, updated or removed. The content of its subdirectories is
+  // detached too, the nodes are kept because entries can still point to them
+  // and they are reused when their paths are listed again.
+  auto parent_path = ParentPath(normalized);
+  auto* parent = Lookup(HashPath(parent_path), parent_path);
+  if (parent == nullptr || !parent->is_scanned) {
+    return;
+  }
+
+  Forget(*parent);
+  parent->children.clear();
+  parent->is_scanned = false;
+  is_fully_scanned_ = false;
+}
+
+auto PathIndex::Lookup(PathId id, std::string_view path) const
+    -> PathIndexNode* {
+  // Paths are compared to get rid of false positives from paths that are not
+  // indexed but share the same hash.
+  if (auto it = ids_.find(id);
+      it != ids_.end() && IsSamePath(it->second->path, path)) {
+    return it->second;
+  }
+
+  return nullptr;
+}
+
+auto PathIndex::FindOrScan(std::string_view normalized) -> PathIndexNode* {
+  if (auto* node = Lookup(HashPath(normalized), normalized); node != nullptr) {
+    return node;
+  }
+
+  if (normalized == "/") {
+    return nullptr;
+  }
+
+  auto* parent = FindOrScan(ParentPath(normalized));
+  if (parent == nullptr || !parent->is_directory || parent->is_scanned) {
+    return nullptr;
+  }
+
+  Scan(*parent);
+  return Lookup(HashPath(normalized), normalized);
+}
+
+auto PathIndex::Scan(PathIndexNode& node) -> void {
+  CHR_ZONE_SCOPED();
+
+  node.is_scanned = true;
+
+  std::error_code error{};
+  std::filesystem::directory_iterator iterator{GetNativePath(node.path),
+                                               error};
+  if (error) {
+    log::Warn("Failed to list {}: {}", node.path, error.message());
+    return;
+  }
+
+  for (const auto& dir_entry : iterator) {
+    auto path = node.path == "/" ? std::string{"/"} : node.path + "/";
+    path += dir_entry.path().filename().string();
+
+    auto id = HashPath(path);
+    if (auto it = ids_.find(id); it != ids_.end()) {
+      log::Warn("Path {} has the same identifier of {}, it's skipped", path,
+                it->second->path);
+      continue;
+    }
+
+    // The node of a path listed before is reused, so the index doesn't grow
+    // every time a directory is refreshed.
+    PathIndexNode* child = nullptr;
+    if (auto it = detached_.find(id);
+        it != detached_.end() && IsSamePath(it->second->path, path)) {
+      child = it->second;
+      detached_.erase(it);
+      child->children.clear();
+      child->is_scanned = false;
+    } else {
+      child = &nodes_.emplace_back();
+      child->path = std::move(path);
+    }
+
+    child->size = 0;
+    child->is_directory = dir_entry.is_directory(error);
+    if (!child->is_directory) {
+      child->size = static_cast<size_t>(dir_entry.file_size(error));
+      if (error) {
+        child->size = 0;
+      }
+    }
+
+    ids_.emplace(id, child);
+    node.children.push_back(child);
+  }
+
+  std::ranges::sort(node.children, {}, &PathIndexNode::path);
+}
+
+auto PathIndex::ScanAll() -> void {
+  CHR_ZONE_SCOPED();
+
+  // Nodes are appended while the directories are scanned, an index based loop
+  // visits the new ones too. The detached nodes are skipped.
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    auto& node = nodes_[i];
+    if (!node.is_directory || node.is_scanned) {
+      continue;
+    }
+
+    if (auto it = ids_.find(HashPath(node.path));
+        it != ids_.end() && it->second == &node) {
+      Scan(node);
+    }
+  }
+
+  is_fully_scanned_ = true;
+}
+
+auto PathIndex::Forget(const PathIndexNode& node) -> void {
+  for (const auto* child : node.children) {
+    Forget(*child);
+
+    auto id = HashPath(child->path);
+    if (auto it = ids_.find(id); it != ids_.end()) {
+      detached_.insert_or_assign(id, it->second);
+      ids_.erase(it);
+    }
+  }
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,66 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_FILESYSTEM_PATH_INDEX_H_
+#define CHR_STORAGE_FILESYSTEM_PATH_INDEX_H_
+
+#include <deque>
+#include <filesystem>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+
+#include "path.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct PathIndexNode {
+  std::string path{};
+  size_t size{0};
+  bool is_directory{false};
+  bool is_scanned{false};
+  std::vector<const PathIndexNode*> children{};
+};
+
+// Index of the paths under a base directory. Directories are listed once,
+// the first time a path inside them is requested, and the metadata of their
+// children is kept so that lookups don't touch the filesystem again.
+// Nodes are never removed, so the returned pointers are valid as long as the
+// index is alive. The nodes of the refreshed directories are detached and
+// reused by path when they are listed again.
+struct PathIndex {
+  explicit PathIndex(std::filesystem::path base_path);
+
+  PathIndex(const PathIndex&) = delete;
+  PathIndex(PathIndex&& other) noexcept = delete;
+
+  PathIndex& operator=(const PathIndex&) = delete;
+  PathIndex& operator=(PathIndex&& other) noexcept = delete;
+
+  auto Find(std::string_view path) -> const PathIndexNode*;
+  auto Find(PathId id) -> const PathIndexNode*;
+  auto GetChildren(const PathIndexNode& node)
+      -> std::span<const PathIndexNode* const>;
+  auto GetNativePath(std::string_view path) const -> std::filesystem::path;
+  auto Refresh(std::string_view path) -> void;
+
+ private:
+  auto Lookup(PathId id, std::string_view path) const -> PathIndexNode*;
+  auto FindOrScan(std::string_view normalized) -> PathIndexNode*;
+  auto Scan(PathIndexNode& node) -> void;
+  auto ScanAll() -> void;
+  auto Forget(const PathIndexNode& node) -> void;
+
+  std::filesystem::path base_path_;
+  mutable std::shared_mutex mutex_{};
+  std::deque<PathIndexNode> nodes_{};
+  std::unordered_map<PathId, PathIndexNode*> ids_{};
+  std::unordered_map<PathId, PathIndexNode*> detached_{};
+  bool is_fully_scanned_{false};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_FILESYSTEM_PATH_INDEX_H_
@@ -0,0 +1,100 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "hash.h"
+
+#include <bit>
+#include <cstring>
+
+namespace chr::storage {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+// Unaligned loads, the supported platforms are little endian like the pack
+// format.
+static auto Read64(const uint8_t* data) -> uint64_t {
+  uint64_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static auto Read32(const uint8_t* data) -> uint32_t {
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static auto Round(uint64_t accumulator, uint64_t input) -> uint64_t {
+  accumulator += input * kPrime2;
+  accumulator = std::rotl(accumulator, 31);
+  return accumulator * kPrime1;
+}
+
+static auto MergeRound(uint64_t accumulator, uint64_t value) -> uint64_t {
+  accumulator ^= Round(0, value);
+  return accumulator * kPrime1 + kPrime4;
+}
+
+auto HashContent(std::span<const uint8_t> data) -> ContentHash {
+  CHR_ZONE_SCOPED();
+
+  const auto* input = data.data();
+  const auto* end = input + data.size();
+  uint64_t hash = 0;
+
+  if (data.size() >= 32) {
+    uint64_t v1 = kPrime1 + kPrime2;
+    uint64_t v2 = kPrime2;
+    uint64_t v3 = 0;
+    uint64_t v4 = 0 - kPrime1;
+
+    // Four independent lanes of 8 bytes, so the rounds run in parallel.
+    for (; end - input >= 32; input += 32) {
+      v1 = Round(v1, Read64(input));
+      v2 = Round(v2, Read64(input + 8));
+      v3 = Round(v3, Read64(input + 16));
+      v4 = Round(v4, Read64(input + 24));
+    }
+
+    hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) +
+           std::rotl(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = kPrime5;
+  }
+
+  hash += data.size();
+
+  for (; end - input >= 8; input += 8) {
+    hash ^= Round(0, Read64(input));
+    hash = std::rotl(hash, 27) * kPrime1 + kPrime4;
+  }
+
+  if (end - input >= 4) {
+    hash ^= uint64_t{Read32(input)} * kPrime1;
+    hash = std::rotl(hash, 23) * kPrime2 + kPrime3;
+    input += 4;
+  }
+
+  for (; input < end; input++) {
+    hash ^= uint64_t{*input} * kPrime5;
+    hash = std::rotl(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}  // namespace chr::storage
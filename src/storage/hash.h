@@ -0,0 +1,26 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_HASH_H_
+#define CHR_STORAGE_HASH_H_
+
+#include <span>
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Hash of a file content, see HashContent.
+using ContentHash = uint64_t;
+
+//! @brief Hash a file content with the 64 bit XXH64 function (seed 0). It's
+//!        fast enough to hash the assets while they are loaded, it's not a
+//!        cryptographic hash.
+//! @param data Content to hash.
+//! @return Content hash.
+auto HashContent(std::span<const uint8_t> data) -> ContentHash;
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_HASH_H_
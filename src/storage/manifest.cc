@@ -0,0 +1,127 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "manifest.h"
+
+#include <fstream>
+
+// Manifest file layout (little endian):
+//
+//   ManifestHeader
+//   PathId[file_count]
+//   uint64_t[file_count]        sizes
+//   int64_t[file_count]         modified times
+//   ContentHash[file_count]
+//   uint32_t[file_count + 1]    path offsets
+//   char[paths_size]            paths
+
+namespace chr::storage {
+
+constexpr std::array<char, 4> kManifestMagic{'C', 'H', 'R', 'M'};
+constexpr uint32_t kManifestVersion = 1;
+
+struct ManifestHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint64_t file_count;
+  uint64_t paths_size;
+};
+
+// Bytes stored for every file, the path characters excluded.
+constexpr size_t kManifestFileSize = sizeof(PathId) + sizeof(uint64_t) +
+                                     sizeof(int64_t) + sizeof(ContentHash) +
+                                     sizeof(uint32_t);
+
+template <typename T>
+static auto WriteArray(std::ofstream& stream, const std::vector<T>& data)
+    -> void {
+  stream.write(std::bit_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+template <typename T>
+static auto ReadArray(std::ifstream& stream, std::vector<T>& data, size_t size)
+    -> void {
+  data.resize(size);
+  stream.read(std::bit_cast<char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+auto Manifest::Find(PathId id) const -> std::optional<size_t> {
+  auto it = std::ranges::lower_bound(ids, id);
+  if (it == ids.end() || *it != id) {
+    return std::nullopt;
+  }
+
+  return static_cast<size_t>(it - ids.begin());
+}
+
+auto Manifest::Save(const std::filesystem::path& path) const -> void {
+  CHR_ZONE_SCOPED();
+
+  ManifestHeader header{.magic = kManifestMagic,
+                        .version = kManifestVersion,
+                        .file_count = ids.size(),
+                        .paths_size = paths.size()};
+
+  std::ofstream stream{};
+  stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  stream.open(path, std::ios::binary | std::ios::trunc);
+
+  stream.write(std::bit_cast<const char*>(&header), sizeof(header));
+  WriteArray(stream, ids);
+  WriteArray(stream, sizes);
+  WriteArray(stream, modified_times);
+  WriteArray(stream, hashes);
+  WriteArray(stream, path_offsets);
+  stream.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+}
+
+auto Manifest::Load(const std::filesystem::path& path) -> Manifest {
+  CHR_ZONE_SCOPED();
+
+  std::ifstream stream{};
+  stream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+  stream.open(path, std::ios::binary);
+
+  ManifestHeader header{};
+  stream.read(std::bit_cast<char*>(&header), sizeof(header));
+
+  // The counts are checked against the file size before anything is
+  // allocated.
+  auto data_size = std::filesystem::file_size(path) - sizeof(header);
+  auto is_count_valid = header.file_count <= data_size / kManifestFileSize;
+  auto arrays_size =
+      is_count_valid ? header.file_count * kManifestFileSize + sizeof(uint32_t)
+                     : 0;
+  if (header.magic != kManifestMagic || header.version != kManifestVersion ||
+      !is_count_valid || arrays_size > data_size ||
+      header.paths_size != data_size - arrays_size) {
+    throw std::runtime_error(
+        fmt::format("Invalid manifest file {}", path.string()));
+  }
+
+  Manifest manifest{};
+  ReadArray(stream, manifest.ids, header.file_count);
+  ReadArray(stream, manifest.sizes, header.file_count);
+  ReadArray(stream, manifest.modified_times, header.file_count);
+  ReadArray(stream, manifest.hashes, header.file_count);
+  ReadArray(stream, manifest.path_offsets, header.file_count + 1);
+  manifest.paths.resize(header.paths_size);
+  stream.read(manifest.paths.data(),
+              static_cast<std::streamsize>(manifest.paths.size()));
+
+  // Find needs sorted identifiers and GetPath increasing offsets.
+  if (!std::ranges::is_sorted(manifest.ids) ||
+      !std::ranges::is_sorted(manifest.path_offsets) ||
+      manifest.path_offsets.front() != 0 ||
+      manifest.path_offsets.back() != manifest.paths.size()) {
+    throw std::runtime_error(
+        fmt::format("Invalid manifest file {}", path.string()));
+  }
+
+  return manifest;
+}
+
+}  // namespace chr::storage
@@ -0,0 +1,71 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MANIFEST_H_
+#define CHR_STORAGE_MANIFEST_H_
+
+#include <filesystem>
+#include <optional>
+
+#include "hash.h"
+#include "path.h"
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Flat list of the files of a storage, see Storage::BuildManifest.
+//!        The data is stored as a struct of arrays sorted by path
+//!        identifier, the same index refers to the same file in every array.
+struct Manifest {
+  //! @brief Path identifiers, see HashPath.
+  std::vector<PathId> ids{};
+
+  //! @brief File sizes.
+  std::vector<uint64_t> sizes{};
+
+  //! @brief Last modification times, in nanoseconds since the epoch of
+  //!        std::filesystem::file_time_type. It's zero when the backend
+  //!        doesn't serve the file from a local file.
+  std::vector<int64_t> modified_times{};
+
+  //! @brief Content hashes, see HashContent. They are zero when the manifest
+  //!        is built without hashes.
+  std::vector<ContentHash> hashes{};
+
+  //! @brief Offset of every path in paths, with an extra element at the end.
+  std::vector<uint32_t> path_offsets{};
+
+  //! @brief Normalized paths, one after the other.
+  std::string paths{};
+
+  //! @brief Get the number of files.
+  //! @return Number of files.
+  [[nodiscard]] auto Size() const -> size_t { return ids.size(); }
+
+  //! @brief Get the path of a file.
+  //! @param index Index of the file.
+  //! @return Normalized path.
+  [[nodiscard]] auto GetPath(size_t index) const -> std::string_view {
+    return std::string_view{paths}.substr(
+        path_offsets[index], path_offsets[index + 1] - path_offsets[index]);
+  }
+
+  //! @brief Find a file with a binary search.
+  //! @param id Path identifier.
+  //! @return Index of the file, or an empty optional if it's not found.
+  [[nodiscard]] auto Find(PathId id) const -> std::optional<size_t>;
+
+  //! @brief Save the manifest to a binary file.
+  //! @param path Path of the manifest file on the local filesystem.
+  auto Save(const std::filesystem::path& path) const -> void;
+
+  //! @brief Load a manifest saved with Save.
+  //! @param path Path of the manifest file on the local filesystem.
+  //! @return Loaded manifest.
+  static auto Load(const std::filesystem::path& path) -> Manifest;
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_MANIFEST_H_
@@ -0,0 +1,133 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "manifest_builder.h"
+
+namespace chr::storage::internal {
+
+ManifestBuilder::ManifestBuilder(const Storage& storage, bool hash_content)
+    : storage_(storage), hash_content_(hash_content) {}
+
+auto ManifestBuilder::Build(std::string_view path) -> Manifest {
+  CHR_ZONE_SCOPED();
+
+  Submit(NormalizePath(path));
+
+  // The tasks can't wait for the tasks of the subdirectories without
+  // blocking the workers, so the directories in flight are counted.
+  {
+    std::unique_lock lock{mutex_};
+    condition_.wait(lock, [this] { return pending_ == 0; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  std::ranges::sort(files_, {}, &ManifestFile::id);
+
+  Manifest manifest{};
+  manifest.ids.reserve(files_.size());
+  manifest.sizes.reserve(files_.size());
+  manifest.modified_times.reserve(files_.size());
+  manifest.hashes.reserve(files_.size());
+  manifest.path_offsets.reserve(files_.size() + 1);
+  for (const auto& file : files_) {
+    manifest.ids.push_back(file.id);
+    manifest.sizes.push_back(file.size);
+    manifest.modified_times.push_back(file.modified_time);
+    manifest.hashes.push_back(file.hash);
+    manifest.path_offsets.push_back(
+        static_cast<uint32_t>(manifest.paths.size()));
+    manifest.paths += file.path;
+  }
+  manifest.path_offsets.push_back(static_cast<uint32_t>(manifest.paths.size()));
+
+  return manifest;
+}
+
+auto ManifestBuilder::Submit(std::string path) -> void {
+  {
+    std::lock_guard lock{mutex_};
+    ++pending_;
+  }
+
+  thread_pool_.Submit([this, path = std::move(path)] {
+    try {
+      ScanDirectory(path);
+    } catch (...) {
+      std::lock_guard lock{mutex_};
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+
+    std::lock_guard lock{mutex_};
+    if (--pending_ == 0) {
+      condition_.notify_all();
+    }
+  });
+}
+
+auto ManifestBuilder::ScanDirectory(const std::string& path) -> void {
+  CHR_ZONE_SCOPED();
+
+  {
+    std::lock_guard lock{mutex_};
+    if (error_ != nullptr) {
+      return;
+    }
+  }
+
+  std::string parent{path == "/" ? "" : path};
+  std::vector<ManifestFile> files{};
+  for (const auto& entry : storage_.GetEntries(path)) {
+    auto child = parent + "/" + std::string{entry.Name()};
+    if (entry.IsDirectory()) {
+      Submit(std::move(child));
+      continue;
+    }
+
+    files.push_back(ScanFile(std::move(child), entry));
+  }
+
+  std::lock_guard lock{mutex_};
+  std::ranges::move(files, std::back_inserter(files_));
+}
+
+auto ManifestBuilder::ScanFile(std::string path, const Entry& entry) const
+    -> ManifestFile {
+  ManifestFile file{.id = HashPath(path),
+                    .size = entry.Size(),
+                    .modified_time = 0,
+                    .hash = 0,
+                    .path = std::move(path)};
+
+  auto native_path = storage_.GetNativePath(file.path);
+  if (!native_path.empty()) {
+    std::error_code error{};
+    auto time = std::filesystem::last_write_time(native_path, error);
+    if (!error) {
+      file.modified_time =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              time.time_since_epoch())
+              .count();
+    }
+  }
+
+  if (hash_content_) {
+    auto content = entry.GetFile(FileMode::kMapped);
+    content.Open();
+    auto data = content.Map();
+    if (data.empty() && file.size > 0) {
+      file.hash = HashContent(content.ReadAll());
+    } else {
+      file.hash = HashContent(data);
+    }
+    content.Close();
+  }
+
+  return file;
+}
+
+}  // namespace chr::storage::internal
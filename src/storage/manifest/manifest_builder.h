@@ -0,0 +1,53 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MANIFEST_MANIFEST_BUILDER_H_
+#define CHR_STORAGE_MANIFEST_MANIFEST_BUILDER_H_
+
+#include "manifest.h"
+#include "pch.h"
+#include "storage.h"
+
+namespace chr::storage::internal {
+
+//! @brief Scan a storage on a thread pool and collect the scanned files in a
+//!        manifest. Every directory is scanned by a separate task, the files
+//!        are hashed by the task that finds them.
+struct ManifestBuilder {
+  //! @brief Create the builder.
+  //! @param storage Storage to scan, it must outlive the builder.
+  //! @param hash_content Hash the content of the files.
+  ManifestBuilder(const Storage& storage, bool hash_content);
+
+  //! @brief Scan a directory and its subdirectories.
+  //! @param path Directory to scan.
+  //! @return Manifest of the scanned files.
+  auto Build(std::string_view path) -> Manifest;
+
+ private:
+  struct ManifestFile {
+    PathId id;
+    uint64_t size;
+    int64_t modified_time;
+    ContentHash hash;
+    std::string path;
+  };
+
+  auto Submit(std::string path) -> void;
+  auto ScanDirectory(const std::string& path) -> void;
+  auto ScanFile(std::string path, const Entry& entry) const -> ManifestFile;
+
+  const Storage& storage_;
+  bool hash_content_;
+  utils::ThreadPool thread_pool_{};
+  std::mutex mutex_{};
+  std::condition_variable condition_{};
+  size_t pending_{0};
+  std::exception_ptr error_{};
+  std::vector<ManifestFile> files_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_MANIFEST_MANIFEST_BUILDER_H_
@@ -0,0 +1,22 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "memory_entry.h"
+
+#include "memory_storage.h"
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(MemoryEntry) <= kEntrySize);
+
+auto MemoryEntry::Size() const -> size_t {
+  auto data = tree_->GetData(*node_);
+  return data != nullptr ? data->size() : 0;
+}
+
+auto MemoryEntry::GetFile(FileMode /*mode*/) const -> File {
+  return MemoryStorage::OpenFile(tree_->GetData(*node_));
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,47 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MEMORY_MEMORY_ENTRY_H_
+#define CHR_STORAGE_MEMORY_MEMORY_ENTRY_H_
+
+#include "entry.h"
+#include "memory_tree.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct MemoryEntry : EntryI {
+  explicit MemoryEntry(std::shared_ptr<const MemoryTree> tree,
+                       const MemoryNode* node)
+      : tree_{std::move(tree)}, node_{node} {};
+
+  MemoryEntry(const MemoryEntry&) = delete;
+  MemoryEntry(MemoryEntry&& other) noexcept
+      : tree_{std::move(other.tree_)}, node_{other.node_} {}
+
+  MemoryEntry& operator=(const MemoryEntry&) = delete;
+  MemoryEntry& operator=(MemoryEntry&& other) noexcept = delete;
+
+  auto Name() const -> std::string_view { return PathName(node_->path); };
+
+  auto HaveExtension() const -> bool { return !Extension().empty(); }
+
+  auto Extension() const -> std::string_view {
+    return PathExtension(Name());
+  };
+
+  auto IsDirectory() const -> bool { return node_->is_directory; }
+
+  auto Size() const -> size_t;
+
+  auto GetFile(FileMode mode) const -> File;
+
+ private:
+  std::shared_ptr<const MemoryTree> tree_;
+  const MemoryNode* node_;
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_MEMORY_MEMORY_ENTRY_H_
@@ -0,0 +1,37 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "memory_file.h"
+
+#include <system_error>
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(MemoryFile) <= kFileSize);
+
+auto MemoryFile::Open() -> void {
+  if (data_ == nullptr) {
+    throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "Failed to open file");
+  }
+
+  is_open_ = true;
+  cursor_.Reset();
+}
+
+auto MemoryFile::Close() -> void {
+  is_open_ = false;
+  cursor_.Reset();
+}
+
+auto MemoryFile::Map() const -> std::span<const uint8_t> {
+  if (!is_open_) {
+    return {};
+  }
+
+  return *data_;
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MEMORY_MEMORY_FILE_H_
+#define CHR_STORAGE_MEMORY_MEMORY_FILE_H_
+
+#include "file.h"
+#include "file_cursor.h"
+#include "memory_tree.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct MemoryFile : FileI {
+  explicit MemoryFile(MemoryData data) : data_{std::move(data)} {};
+
+  MemoryFile(const MemoryFile&) = delete;
+  MemoryFile(MemoryFile&& other) noexcept
+      : data_{std::move(other.data_)},
+        is_open_{other.is_open_},
+        cursor_{other.cursor_} {}
+
+  MemoryFile& operator=(const MemoryFile&) = delete;
+  MemoryFile& operator=(MemoryFile&& other) noexcept = delete;
+
+  auto Open() -> void;
+  auto IsOpen() const -> bool { return is_open_; }
+  auto Close() -> void;
+  auto Seek(size_t offset, SeekDir direction) -> void {
+    cursor_.Seek(Map().size(), offset, direction);
+  }
+  auto Position() -> size_t { return cursor_.Position(); }
+  auto Read(uint8_t* buffer, size_t size) -> void {
+    cursor_.Read(Map(), buffer, size);
+  }
+  auto Map() const -> std::span<const uint8_t>;
+  auto ReadAt(size_t offset, uint8_t* buffer, size_t size) const -> void {
+    FileCursor::ReadAt(Map(), offset, buffer, size);
+  }
+
+ private:
+  MemoryData data_;
+  bool is_open_{false};
+  FileCursor cursor_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_MEMORY_MEMORY_FILE_H_
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "memory_storage.h"
+
+#include <system_error>
+
+#include "file_cursor.h"
+#include "memory_entry.h"
+#include "memory_file.h"
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(MemoryStorage) <= kStorageSize);
+
+auto MemoryStorage::GetEntries(std::string_view path) const
+    -> std::vector<Entry> {
+  CHR_ZONE_SCOPED();
+
+  const auto* directory = tree_->Find(path);
+  if (directory == nullptr || !directory->is_directory) {
+    throw std::filesystem::filesystem_error(
+        "Directory not found in memory", path,
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+
+  auto children = tree_->GetChildren(*directory);
+
+  std::vector<Entry> entries{};
+  entries.reserve(children.size());
+  for (const auto* child : children) {
+    Entry entry{};
+    entry.Emplace<MemoryEntry>(tree_, child);
+    entries.emplace_back(std::move(entry));
+  }
+
+  return entries;
+}
+
+auto MemoryStorage::GetFile(std::string_view path, FileMode /*mode*/) const
+    -> File {
+  // Missing files are reported when they are opened, like for the other
+  // backends.
+  const auto* node = tree_->Find(path);
+  return OpenFile(node != nullptr ? tree_->GetData(*node) : nullptr);
+}
+
+auto MemoryStorage::GetEntry(std::string_view path) const
+    -> std::optional<Entry> {
+  return MakeEntry(tree_->Find(path));
+}
+
+auto MemoryStorage::GetEntryById(PathId id) const -> std::optional<Entry> {
+  return MakeEntry(tree_->Find(id));
+}
+
+auto MemoryStorage::AddFile(std::string_view path, std::vector<uint8_t> data)
+    -> void {
+  tree_->AddFile(path,
+                 std::make_shared<const std::vector<uint8_t>>(std::move(data)));
+}
+
+auto MemoryStorage::AddFiles(const Storage& storage, std::string_view path)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  auto directory = NormalizePath(path);
+  tree_->AddDirectory(directory);
+
+  std::string parent{directory == "/" ? "" : directory};
+  for (const auto& entry : storage.GetEntries(directory)) {
+    auto child = parent + "/" + std::string{entry.Name()};
+    if (entry.IsDirectory()) {
+      AddFiles(storage, child);
+      continue;
+    }
+
+    auto file = entry.GetFile(FileMode::kMapped);
+    file.Open();
+    AddFile(child, file.ReadAll());
+    file.Close();
+  }
+}
+
+auto MemoryStorage::ReadMany(std::span<const ReadRequest> requests) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  for (const auto& request : requests) {
+    const auto* node = tree_->Find(request.path);
+    auto data = node != nullptr ? tree_->GetData(*node) : nullptr;
+    if (data == nullptr) {
+      throw std::system_error(
+          std::make_error_code(std::errc::no_such_file_or_directory),
+          "Failed to open file");
+    }
+
+    FileCursor::ReadAt(*data, request.offset, request.buffer.data(),
+                       request.buffer.size());
+  }
+}
+
+auto MemoryStorage::OpenFile(MemoryData data) -> File {
+  File file{};
+  file.Emplace<MemoryFile>(std::move(data));
+  return file;
+}
+
+auto MemoryStorage::MakeEntry(const MemoryNode* node) const
+    -> std::optional<Entry> {
+  if (node == nullptr) {
+    return std::nullopt;
+  }
+
+  Entry entry{};
+  entry.Emplace<MemoryEntry>(tree_, node);
+  return entry;
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,52 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MEMORY_MEMORY_STORAGE_H_
+#define CHR_STORAGE_MEMORY_MEMORY_STORAGE_H_
+
+#include "memory_tree.h"
+#include "pch.h"
+#include "storage.h"
+
+namespace chr::storage::internal {
+
+struct MemoryStorage : StorageI {
+  explicit MemoryStorage() : tree_{std::make_shared<MemoryTree>()} {}
+
+  MemoryStorage(const MemoryStorage&) = delete;
+  MemoryStorage(MemoryStorage&& other) noexcept
+      : tree_{std::move(other.tree_)} {}
+
+  MemoryStorage& operator=(const MemoryStorage&) = delete;
+  MemoryStorage& operator=(MemoryStorage&& other) noexcept = delete;
+
+  auto SetBasePath(std::string_view /*path*/) -> void {}
+
+  auto GetEntries(std::string_view path) const -> std::vector<Entry>;
+  auto GetFile(std::string_view path, FileMode mode) const -> File;
+  auto GetNativePath(std::string_view /*path*/) const
+      -> std::filesystem::path {
+    return {};
+  }
+  auto GetEntry(std::string_view path) const -> std::optional<Entry>;
+  auto GetEntryById(PathId id) const -> std::optional<Entry>;
+  auto Refresh(std::string_view /*path*/) -> void {}
+  auto ReadMany(std::span<const ReadRequest> requests) const -> void;
+  auto GetStats() const -> StorageStats { return {}; }
+  auto SetBlockCache(std::shared_ptr<BlockCache> /*cache*/) -> void {}
+
+  auto AddFile(std::string_view path, std::vector<uint8_t> data) -> void;
+  auto AddFiles(const Storage& storage, std::string_view path) -> void;
+
+  static auto OpenFile(MemoryData data) -> File;
+
+ private:
+  auto MakeEntry(const MemoryNode* node) const -> std::optional<Entry>;
+
+  std::shared_ptr<MemoryTree> tree_;
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_MEMORY_MEMORY_STORAGE_H_
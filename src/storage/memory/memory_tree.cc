@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "memory_tree.h"
+
+#include <filesystem>
+#include <mutex>
+
+namespace chr::storage::internal {
+
+MemoryTree::MemoryTree() {
+  auto& root = nodes_.emplace_back();
+  root.path = "/";
+  root.is_directory = true;
+  ids_.emplace(HashPath(root.path), &root);
+}
+
+auto MemoryTree::Find(std::string_view path) const -> const MemoryNode* {
+  std::shared_lock lock{mutex_};
+  return Lookup(HashPath(path), path);
+}
+
+auto MemoryTree::Find(PathId id) const -> const MemoryNode* {
+  std::shared_lock lock{mutex_};
+  auto it = ids_.find(id);
+  return it != ids_.end() ? it->second : nullptr;
+}
+
+auto MemoryTree::GetChildren(const MemoryNode& node) const
+    -> std::vector<const MemoryNode*> {
+  // Files can be added while the children are listed, so a copy is returned.
+  std::shared_lock lock{mutex_};
+  return node.children;
+}
+
+auto MemoryTree::GetData(const MemoryNode& node) const -> MemoryData {
+  std::shared_lock lock{mutex_};
+  return node.data;
+}
+
+auto MemoryTree::AddFile(std::string_view path, MemoryData data) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto normalized = NormalizePath(path);
+
+  std::unique_lock lock{mutex_};
+  FindOrCreate(normalized, false).data = std::move(data);
+}
+
+auto MemoryTree::AddDirectory(std::string_view path) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto normalized = NormalizePath(path);
+
+  std::unique_lock lock{mutex_};
+  FindOrCreate(normalized, true);
+}
+
+auto MemoryTree::Lookup(PathId id, std::string_view path) const
+    -> MemoryNode* {
+  // Paths are compared to get rid of false positives from paths that are not
+  // in the tree but share the same hash.
+  if (auto it = ids_.find(id);
+      it != ids_.end() && IsSamePath(it->second->path, path)) {
+    return it->second;
+  }
+
+  return nullptr;
+}
+
+auto MemoryTree::FindOrCreate(std::string_view normalized, bool is_directory)
+    -> MemoryNode& {
+  if (auto* node = Lookup(HashPath(normalized), normalized); node != nullptr) {
+    if (node->is_directory != is_directory) {
+      throw std::filesystem::filesystem_error(
+          is_directory ? "File already exists" : "Directory already exists",
+          normalized, std::make_error_code(std::errc::file_exists));
+    }
+
+    return *node;
+  }
+
+  if (ids_.contains(HashPath(normalized))) {
+    throw std::filesystem::filesystem_error(
+        "Path has the same identifier of another path", normalized,
+        std::make_error_code(std::errc::file_exists));
+  }
+
+  // Missing parent directories are created too.
+  auto& parent = FindOrCreate(ParentPath(normalized), true);
+
+  auto& node = nodes_.emplace_back();
+  node.path = normalized;
+  node.is_directory = is_directory;
+  ids_.emplace(HashPath(node.path), &node);
+
+  auto it = std::ranges::lower_bound(parent.children, node.path, {},
+                                     &MemoryNode::path);
+  parent.children.insert(it, &node);
+  return node;
+}
+
+}  // namespace chr::storage::internal
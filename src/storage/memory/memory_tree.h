@@ -0,0 +1,60 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_MEMORY_MEMORY_TREE_H_
+#define CHR_STORAGE_MEMORY_MEMORY_TREE_H_
+
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "path.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+using MemoryData = std::shared_ptr<const std::vector<uint8_t>>;
+
+struct MemoryNode {
+  std::string path{};
+  bool is_directory{false};
+  MemoryData data{};
+  std::vector<const MemoryNode*> children{};
+};
+
+// Tree of the files held in memory. The content of a file is shared with the
+// files opened from it, so replacing it doesn't invalidate the open files.
+// Nodes are never removed, so the returned pointers are valid as long as the
+// tree is alive.
+struct MemoryTree {
+  explicit MemoryTree();
+
+  MemoryTree(const MemoryTree&) = delete;
+  MemoryTree(MemoryTree&& other) noexcept = delete;
+
+  MemoryTree& operator=(const MemoryTree&) = delete;
+  MemoryTree& operator=(MemoryTree&& other) noexcept = delete;
+
+  auto Find(std::string_view path) const -> const MemoryNode*;
+  auto Find(PathId id) const -> const MemoryNode*;
+  auto GetChildren(const MemoryNode& node) const
+      -> std::vector<const MemoryNode*>;
+  auto GetData(const MemoryNode& node) const -> MemoryData;
+
+  auto AddFile(std::string_view path, MemoryData data) -> void;
+  auto AddDirectory(std::string_view path) -> void;
+
+ private:
+  auto Lookup(PathId id, std::string_view path) const -> MemoryNode*;
+  auto FindOrCreate(std::string_view normalized, bool is_directory)
+      -> MemoryNode&;
+
+  mutable std::shared_mutex mutex_{};
+  std::deque<MemoryNode> nodes_{};
+  std::unordered_map<PathId, MemoryNode*> ids_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_MEMORY_MEMORY_TREE_H_
@@ -0,0 +1,273 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "overlay_storage.h"
+
+#include <algorithm>
+#include <system_error>
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(OverlayStorage) <= kStorageSize);
+
+auto OverlayStorage::GetEntries(std::string_view path) const
+    -> std::vector<Entry> {
+  CHR_ZONE_SCOPED();
+
+  const auto* directory = Find(path);
+  if (directory == nullptr || !directory->is_directory) {
+    throw std::filesystem::filesystem_error(
+        "Directory not found in overlay", path,
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+
+  std::vector<Entry> entries{};
+  entries.reserve(directory->children.size());
+  for (const auto* child : directory->children) {
+    const auto& storage = table_->layers[child->layer].storage;
+    if (auto entry = storage.GetEntry(child->path); entry) {
+      entries.emplace_back(std::move(*entry));
+    }
+  }
+
+  return entries;
+}
+
+auto OverlayStorage::GetFile(std::string_view path, FileMode mode) const
+    -> File {
+  if (table_->layers.empty()) {
+    throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "No storage mounted");
+  }
+
+  // Missing files are reported when they are opened, so they are looked up
+  // in the lowest layer.
+  const auto* node = Find(path);
+  auto layer = node != nullptr ? node->layer : table_->layers.size() - 1;
+  return table_->layers[layer].storage.GetFile(path, mode);
+}
+
+auto OverlayStorage::GetNativePath(std::string_view path) const
+    -> std::filesystem::path {
+  const auto* node = Find(path);
+  if (node == nullptr) {
+    return {};
+  }
+
+  return table_->layers[node->layer].storage.GetNativePath(path);
+}
+
+auto OverlayStorage::GetEntry(std::string_view path) const
+    -> std::optional<Entry> {
+  const auto* node = Find(path);
+  if (node == nullptr) {
+    return std::nullopt;
+  }
+
+  return table_->layers[node->layer].storage.GetEntry(node->path);
+}
+
+auto OverlayStorage::GetEntryById(PathId id) const -> std::optional<Entry> {
+  auto it = table_->ids.find(id);
+  if (it == table_->ids.end()) {
+    return std::nullopt;
+  }
+
+  const auto* node = it->second;
+  return table_->layers[node->layer].storage.GetEntry(node->path);
+}
+
+auto OverlayStorage::Refresh(std::string_view path) -> void {
+  CHR_ZONE_SCOPED();
+
+  for (auto& layer : table_->layers) {
+    layer.storage.Refresh(path);
+  }
+
+  auto normalized = NormalizePath(path);
+  if (normalized == "/") {
+    Rebuild();
+    return;
+  }
+
+  // Only the parent directory is listed again in the layers that have it, so
+  // the path is added, updated or removed without scanning the whole tree.
+  auto parent_path = ParentPath(normalized);
+  auto it = table_->ids.find(HashPath(parent_path));
+  if (it == table_->ids.end() || !IsSamePath(it->second->path, parent_path) ||
+      !it->second->is_directory) {
+    return;
+  }
+
+  auto& parent = *it->second;
+  Forget(parent);
+
+  for (size_t layer = 0; layer < table_->layers.size(); layer++) {
+    if (parent.path != "/") {
+      auto entry = table_->layers[layer].storage.GetEntry(parent.path);
+      if (!entry || !entry->IsDirectory()) {
+        continue;
+      }
+    }
+
+    ScanLayer(layer, parent.path);
+  }
+}
+
+auto OverlayStorage::GetStats() const -> StorageStats {
+  StorageStats stats{};
+  for (const auto& layer : table_->layers) {
+    stats += layer.storage.GetStats();
+  }
+
+  return stats;
+}
+
+auto OverlayStorage::ReadMany(std::span<const ReadRequest> requests) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  if (table_->layers.empty()) {
+    throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "No storage mounted");
+  }
+
+  // Every storage receives a single batch with the paths it serves, the
+  // missing files are reported by the lowest layer like in GetFile.
+  std::vector<std::vector<ReadRequest>> batches(table_->layers.size());
+  for (const auto& request : requests) {
+    const auto* node = Find(request.path);
+    auto layer = node != nullptr ? node->layer : table_->layers.size() - 1;
+    batches[layer].push_back(request);
+  }
+
+  for (size_t layer = 0; layer < batches.size(); layer++) {
+    if (!batches[layer].empty()) {
+      table_->layers[layer].storage.ReadMany(batches[layer]);
+    }
+  }
+}
+
+auto OverlayStorage::SetBlockCache(std::shared_ptr<BlockCache> cache) -> void {
+  for (auto& layer : table_->layers) {
+    layer.storage.SetBlockCache(cache);
+  }
+
+  table_->block_cache = std::move(cache);
+}
+
+auto OverlayStorage::Mount(Storage storage, int32_t priority) -> void {
+  CHR_ZONE_SCOPED();
+
+  // The storages mounted after SetBlockCache share the same cache.
+  if (table_->block_cache != nullptr) {
+    storage.SetBlockCache(table_->block_cache);
+  }
+
+  // Layers are kept from the highest to the lowest priority. With the same
+  // priority the last mounted storage wins.
+  auto it = std::ranges::find_if(table_->layers,
+                                 [priority](const OverlayLayer& layer) {
+                                   return layer.priority <= priority;
+                                 });
+  table_->layers.insert(it, OverlayLayer{std::move(storage), priority});
+
+  Rebuild();
+}
+
+auto OverlayStorage::Find(std::string_view path) const -> const OverlayNode* {
+  // Paths are compared to get rid of false positives from paths that are not
+  // in the overlay but share the same hash.
+  if (auto it = table_->ids.find(HashPath(path));
+      it != table_->ids.end() && IsSamePath(it->second->path, path)) {
+    return it->second;
+  }
+
+  return nullptr;
+}
+
+auto OverlayStorage::Rebuild() -> void {
+  CHR_ZONE_SCOPED();
+
+  table_->nodes.clear();
+  table_->ids.clear();
+  table_->free_nodes.clear();
+
+  auto& root = table_->nodes.emplace_back();
+  root.path = "/";
+  root.is_directory = true;
+  table_->ids.emplace(HashPath(root.path), &root);
+
+  for (size_t layer = 0; layer < table_->layers.size(); layer++) {
+    ScanLayer(layer, "/");
+  }
+}
+
+auto OverlayStorage::ScanLayer(size_t layer, std::string_view directory)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  // The layers are scanned from the top one, so a path that is already in the
+  // table is shadowed by an upper layer. A directory that is shadowed by a
+  // file hides all its content.
+  const auto& storage = table_->layers[layer].storage;
+  auto& parent = *table_->ids.at(HashPath(directory));
+  std::string prefix{directory == "/" ? "" : directory};
+  for (const auto& entry : storage.GetEntries(directory)) {
+    auto path = prefix + "/" + std::string{entry.Name()};
+
+    auto [it, inserted] = table_->ids.try_emplace(HashPath(path), nullptr);
+    if (inserted) {
+      it->second = &AllocateNode();
+      it->second->path = path;
+      it->second->layer = layer;
+      it->second->is_directory = entry.IsDirectory();
+      parent.children.push_back(it->second);
+    }
+
+    const auto* node = it->second;
+    if (node->path != path) {
+      log::Warn("Path {} has the same identifier of {}, it's skipped", path,
+                node->path);
+      continue;
+    }
+
+    if (entry.IsDirectory() && node->is_directory) {
+      ScanLayer(layer, path);
+    }
+  }
+
+  // Children are listed in name order.
+  std::ranges::sort(parent.children, {}, &OverlayNode::path);
+}
+
+auto OverlayStorage::AllocateNode() -> OverlayNode& {
+  if (table_->free_nodes.empty()) {
+    return table_->nodes.emplace_back();
+  }
+
+  auto* node = table_->free_nodes.back();
+  table_->free_nodes.pop_back();
+  return *node;
+}
+
+auto OverlayStorage::Forget(OverlayNode& node) -> void {
+  // The nodes are recycled, the ones removed from the table are not
+  // referenced anywhere else.
+  for (const auto* child : node.children) {
+    auto it = table_->ids.find(HashPath(child->path));
+    auto& forgotten = *it->second;
+    Forget(forgotten);
+    table_->ids.erase(it);
+
+    forgotten = OverlayNode{};
+    table_->free_nodes.push_back(&forgotten);
+  }
+
+  node.children.clear();
+}
+
+}  // namespace chr::storage::internal
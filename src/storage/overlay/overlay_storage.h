@@ -0,0 +1,73 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_OVERLAY_OVERLAY_STORAGE_H_
+#define CHR_STORAGE_OVERLAY_OVERLAY_STORAGE_H_
+
+#include <deque>
+#include <unordered_map>
+
+#include "path.h"
+#include "pch.h"
+#include "storage.h"
+
+namespace chr::storage::internal {
+
+struct OverlayNode {
+  std::string path{};
+  size_t layer{0};
+  bool is_directory{false};
+  std::vector<const OverlayNode*> children{};
+};
+
+struct OverlayLayer {
+  Storage storage;
+  int32_t priority;
+};
+
+struct OverlayTable {
+  std::vector<OverlayLayer> layers{};
+  std::deque<OverlayNode> nodes{};
+  std::unordered_map<PathId, OverlayNode*> ids{};
+  std::vector<OverlayNode*> free_nodes{};
+  std::shared_ptr<BlockCache> block_cache{};
+};
+
+struct OverlayStorage : StorageI {
+  explicit OverlayStorage() : table_{std::make_unique<OverlayTable>()} {}
+
+  OverlayStorage(const OverlayStorage&) = delete;
+  OverlayStorage(OverlayStorage&& other) noexcept
+      : table_{std::move(other.table_)} {}
+
+  OverlayStorage& operator=(const OverlayStorage&) = delete;
+  OverlayStorage& operator=(OverlayStorage&& other) noexcept = delete;
+
+  auto SetBasePath(std::string_view /*path*/) -> void {}
+
+  auto GetEntries(std::string_view path) const -> std::vector<Entry>;
+  auto GetFile(std::string_view path, FileMode mode) const -> File;
+  auto GetNativePath(std::string_view path) const -> std::filesystem::path;
+  auto GetEntry(std::string_view path) const -> std::optional<Entry>;
+  auto GetEntryById(PathId id) const -> std::optional<Entry>;
+  auto Refresh(std::string_view path) -> void;
+  auto GetStats() const -> StorageStats;
+  auto ReadMany(std::span<const ReadRequest> requests) const -> void;
+  auto SetBlockCache(std::shared_ptr<BlockCache> cache) -> void;
+
+  auto Mount(Storage storage, int32_t priority) -> void;
+
+ private:
+  auto Find(std::string_view path) const -> const OverlayNode*;
+  auto Rebuild() -> void;
+  auto ScanLayer(size_t layer, std::string_view directory) -> void;
+  auto AllocateNode() -> OverlayNode&;
+  auto Forget(OverlayNode& node) -> void;
+
+  std::unique_ptr<OverlayTable> table_;
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_OVERLAY_OVERLAY_STORAGE_H_
@@ -0,0 +1,125 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "pack_archive.h"
+
+#include <cstring>
+
+namespace chr::storage::internal {
+
+template <typename T>
+static auto GetSection(std::span<const uint8_t> data, uint64_t offset,
+                       uint64_t count) -> std::span<const T> {
+  if (offset % alignof(T) != 0 || offset > data.size() ||
+      count > (data.size() - offset) / sizeof(T)) {
+    throw std::runtime_error("Invalid pack file section");
+  }
+
+  return {std::bit_cast<const T*>(data.data() + offset),
+          static_cast<size_t>(count)};
+}
+
+PackArchive::PackArchive(const std::filesystem::path& path) : mapping_{path} {
+  CHR_ZONE_SCOPED();
+
+  auto data = mapping_.Data();
+
+  PackHeader header{};
+  if (data.size() < sizeof(header)) {
+    throw std::runtime_error("Invalid pack file");
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kPackMagic) {
+    throw std::runtime_error("Invalid pack file");
+  }
+
+  // Version 2 added compressed entries, older packs are still readable.
+  if (header.version == 0 || header.version > kPackVersion) {
+    throw std::runtime_error("Unsupported pack file version");
+  }
+
+  toc_ = GetSection<PackTocEntry>(data, header.toc_offset, header.entry_count);
+  children_ = GetSection<uint32_t>(data, header.children_offset,
+                                   header.children_count);
+
+  auto strings =
+      GetSection<char>(data, header.strings_offset, header.strings_size);
+  strings_ = {strings.data(), strings.size()};
+
+  for (const auto& entry : toc_) {
+    auto valid = entry.path_offset <= strings_.size() &&
+                 entry.path_size <= strings_.size() - entry.path_offset;
+
+    if ((entry.flags & kPackEntryDirectory) != 0) {
+      valid = valid && entry.offset <= children_.size() &&
+              entry.size <= children_.size() - entry.offset;
+    } else {
+      valid = valid && entry.offset <= data.size() &&
+              entry.size <= data.size() - entry.offset;
+    }
+
+    if (!valid) {
+      throw std::runtime_error("Invalid pack file entry");
+    }
+  }
+
+  if (std::ranges::any_of(children_, [this](uint32_t index) {
+        return index >= toc_.size();
+      })) {
+    throw std::runtime_error("Invalid pack file children table");
+  }
+}
+
+auto PackArchive::Find(std::string_view path) const -> const PackTocEntry* {
+  // Paths are compared to get rid of false positives from paths that are not
+  // in the archive but share the same hash.
+  auto [first, last] = std::ranges::equal_range(toc_, HashPath(path),
+                                                std::less{},
+                                                &PackTocEntry::path_id);
+  for (auto it = first; it != last; ++it) {
+    if (IsSamePath(GetPath(*it), path)) {
+      return &*it;
+    }
+  }
+
+  return nullptr;
+}
+
+auto PackArchive::Find(PathId id) const -> const PackTocEntry* {
+  // The pack writer rejects colliding paths, an identifier matches at most
+  // one entry.
+  auto it = std::ranges::lower_bound(toc_, id, std::less{},
+                                     &PackTocEntry::path_id);
+  if (it == toc_.end() || it->path_id != id) {
+    return nullptr;
+  }
+
+  return &*it;
+}
+
+auto PackArchive::GetPath(const PackTocEntry& entry) const
+    -> std::string_view {
+  return strings_.substr(entry.path_offset, entry.path_size);
+}
+
+auto PackArchive::GetChildren(const PackTocEntry& entry) const
+    -> std::span<const uint32_t> {
+  if ((entry.flags & kPackEntryDirectory) == 0) {
+    return {};
+  }
+
+  return children_.subspan(entry.offset, entry.size);
+}
+
+auto PackArchive::GetData(const PackTocEntry& entry) const
+    -> std::span<const uint8_t> {
+  if ((entry.flags & kPackEntryDirectory) != 0) {
+    return {};
+  }
+
+  return mapping_.Data().subspan(entry.offset, entry.size);
+}
+
+}  // namespace chr::storage::internal
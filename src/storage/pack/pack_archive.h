@@ -0,0 +1,43 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PACK_PACK_ARCHIVE_H_
+#define CHR_STORAGE_PACK_PACK_ARCHIVE_H_
+
+#include <filesystem>
+
+#include "filesystem/file_mapping.h"
+#include "pack_format.h"
+#include "path.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct PackArchive {
+  explicit PackArchive(const std::filesystem::path& path);
+
+  PackArchive(const PackArchive&) = delete;
+  PackArchive(PackArchive&& other) noexcept = delete;
+
+  PackArchive& operator=(const PackArchive&) = delete;
+  PackArchive& operator=(PackArchive&& other) noexcept = delete;
+
+  auto Find(std::string_view path) const -> const PackTocEntry*;
+  auto Find(PathId id) const -> const PackTocEntry*;
+  auto GetPath(const PackTocEntry& entry) const -> std::string_view;
+  auto GetChildren(const PackTocEntry& entry) const
+      -> std::span<const uint32_t>;
+  auto GetData(const PackTocEntry& entry) const -> std::span<const uint8_t>;
+  auto GetEntries() const -> std::span<const PackTocEntry> { return toc_; }
+
+ private:
+  FileMapping mapping_;
+  std::span<const PackTocEntry> toc_{};
+  std::span<const uint32_t> children_{};
+  std::string_view strings_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_PACK_PACK_ARCHIVE_H_
@@ -0,0 +1,31 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "pack_entry.h"
+
+#include "compression/chunked_data.h"
+#include "pack_storage.h"
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(PackEntry) <= kEntrySize);
+
+auto PackEntry::Size() const -> size_t {
+  if (IsDirectory()) {
+    return 0;
+  }
+
+  // The stored size of compressed entries is the size of the container.
+  if ((entry_->flags & kPackEntryCompressed) != 0) {
+    return ChunkedData{archive_->GetData(*entry_)}.Size();
+  }
+
+  return entry_->size;
+}
+
+auto PackEntry::GetFile(FileMode /*mode*/) const -> File {
+  return PackStorage::OpenFile(archive_, entry_);
+}
+
+}  // namespace chr::storage::internal
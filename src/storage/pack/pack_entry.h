@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PACK_PACK_ENTRY_H_
+#define CHR_STORAGE_PACK_PACK_ENTRY_H_
+
+#include "entry.h"
+#include "pack_archive.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct PackEntry : EntryI {
+  explicit PackEntry(std::shared_ptr<const PackArchive> archive,
+                     const PackTocEntry* entry)
+      : archive_{std::move(archive)}, entry_{entry} {};
+
+  PackEntry(const PackEntry&) = delete;
+  PackEntry(PackEntry&& other) noexcept
+      : archive_{std::move(other.archive_)}, entry_{other.entry_} {}
+
+  PackEntry& operator=(const PackEntry&) = delete;
+  PackEntry& operator=(PackEntry&& other) noexcept = delete;
+
+  auto Name() const -> std::string_view {
+    return PathName(archive_->GetPath(*entry_));
+  }
+
+  auto HaveExtension() const -> bool { return !Extension().empty(); }
+
+  auto Extension() const -> std::string_view { return PathExtension(Name()); }
+
+  auto IsDirectory() const -> bool {
+    return (entry_->flags & kPackEntryDirectory) != 0;
+  }
+
+  auto Size() const -> size_t;
+
+  auto GetFile(FileMode mode) const -> File;
+
+ private:
+  std::shared_ptr<const PackArchive> archive_;
+  const PackTocEntry* entry_;
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_PACK_PACK_ENTRY_H_
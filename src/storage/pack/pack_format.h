@@ -0,0 +1,60 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PACK_PACK_FORMAT_H_
+#define CHR_STORAGE_PACK_PACK_FORMAT_H_
+
+#include "pch.h"
+
+// Pack file layout (little endian):
+//
+//   PackHeader
+//   PackTocEntry[entry_count]  sorted by path_id
+//   uint32_t[children_count]   children of every directory, as TOC indices
+//   char[strings_size]         paths of all the entries
+//   file data                  every file aligned to kPackDataAlignment
+//
+// The data of compressed files is a container described in
+// compression/chunked_format.h.
+
+namespace chr::storage::internal {
+
+constexpr std::array<char, 4> kPackMagic{'C', 'H', 'R', 'P'};
+constexpr uint32_t kPackVersion = 2;
+constexpr uint64_t kPackDataAlignment = 16;
+
+enum PackEntryFlags : uint32_t {
+  kPackEntryDirectory = 1 << 0,
+  kPackEntryCompressed = 1 << 1,
+};
+
+struct PackHeader {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t children_count;
+  uint64_t toc_offset;
+  uint64_t children_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+};
+
+// For directories offset is the index of the first child in the children
+// table and size is the number of children.
+struct PackTocEntry {
+  uint64_t path_id;
+  uint64_t offset;
+  uint64_t size;
+  uint32_t path_offset;
+  uint32_t path_size;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 48);
+static_assert(sizeof(PackTocEntry) == 40);
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_PACK_PACK_FORMAT_H_
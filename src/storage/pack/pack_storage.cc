@@ -0,0 +1,135 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "pack_storage.h"
+
+#include <system_error>
+
+#include "compression/compressed_file.h"
+#include "file_cursor.h"
+#include "pack_entry.h"
+#include "pack_file.h"
+
+namespace chr::storage::internal {
+
+static_assert(sizeof(PackStorage) <= kStorageSize);
+
+auto PackStorage::SetBasePath(std::string_view path) -> void {
+  CHR_ZONE_SCOPED();
+
+  archive_ = std::make_shared<PackArchive>(std::filesystem::path{path});
+}
+
+auto PackStorage::GetEntries(std::string_view path) const
+    -> std::vector<Entry> {
+  CHR_ZONE_SCOPED();
+
+  const auto* directory = archive_ ? archive_->Find(path) : nullptr;
+  if (directory == nullptr || (directory->flags & kPackEntryDirectory) == 0) {
+    throw std::filesystem::filesystem_error(
+        "Directory not found in pack", path,
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+
+  auto toc = archive_->GetEntries();
+  auto children = archive_->GetChildren(*directory);
+
+  std::vector<Entry> entries{};
+  entries.reserve(children.size());
+  for (auto index : children) {
+    Entry entry{};
+    entry.Emplace<PackEntry>(archive_, &toc[index]);
+    entries.emplace_back(std::move(entry));
+  }
+
+  return entries;
+}
+
+auto PackStorage::GetFile(std::string_view path, FileMode /*mode*/) const
+    -> File {
+  return OpenFile(archive_, archive_ ? archive_->Find(path) : nullptr);
+}
+
+auto PackStorage::GetEntry(std::string_view path) const
+    -> std::optional<Entry> {
+  return MakeEntry(archive_ ? archive_->Find(path) : nullptr);
+}
+
+auto PackStorage::GetEntryById(PathId id) const -> std::optional<Entry> {
+  return MakeEntry(archive_ ? archive_->Find(id) : nullptr);
+}
+
+auto PackStorage::ReadMany(std::span<const ReadRequest> requests) const
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  struct PackRequest {
+    const ReadRequest* request;
+    const PackTocEntry* entry;
+  };
+
+  std::vector<PackRequest> sorted{};
+  sorted.reserve(requests.size());
+  for (const auto& request : requests) {
+    const auto* entry = archive_ ? archive_->Find(request.path) : nullptr;
+    if (entry == nullptr || (entry->flags & kPackEntryDirectory) != 0) {
+      throw std::system_error(
+          std::make_error_code(std::errc::no_such_file_or_directory),
+          "Failed to open file");
+    }
+    sorted.push_back({.request = &request, .entry = entry});
+  }
+
+  // Requests are served in the order of the data in the pack, so the mapped
+  // pages are touched sequentially.
+  std::ranges::sort(sorted, [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.entry->offset, lhs.request->offset) <
+           std::tie(rhs.entry->offset, rhs.request->offset);
+  });
+
+  std::optional<CompressedFile> compressed{};
+  const PackTocEntry* compressed_entry = nullptr;
+  for (const auto& [request, entry] : sorted) {
+    auto data = archive_->GetData(*entry);
+    auto buffer = request->buffer;
+    if ((entry->flags & kPackEntryCompressed) == 0) {
+      FileCursor::ReadAt(data, request->offset, buffer.data(), buffer.size());
+      continue;
+    }
+
+    // Consecutive requests on the same file share the decompressor.
+    if (compressed_entry != entry) {
+      compressed.emplace(archive_, data);
+      compressed->Open();
+      compressed_entry = entry;
+    }
+    compressed->ReadAt(request->offset, buffer.data(), buffer.size());
+  }
+}
+
+auto PackStorage::OpenFile(const std::shared_ptr<const PackArchive>& archive,
+                           const PackTocEntry* entry) -> File {
+  File file{};
+  if (entry != nullptr && (entry->flags & kPackEntryCompressed) != 0) {
+    file.Emplace<CompressedFile>(archive, archive->GetData(*entry));
+  } else {
+    // Missing files are reported when they are opened, like for the other
+    // backends.
+    file.Emplace<PackFile>(archive, entry);
+  }
+  return file;
+}
+
+auto PackStorage::MakeEntry(const PackTocEntry* toc_entry) const
+    -> std::optional<Entry> {
+  if (toc_entry == nullptr) {
+    return std::nullopt;
+  }
+
+  Entry entry{};
+  entry.Emplace<PackEntry>(archive_, toc_entry);
+  return entry;
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PACK_PACK_STORAGE_H_
+#define CHR_STORAGE_PACK_PACK_STORAGE_H_
+
+#include "pack_archive.h"
+#include "pch.h"
+#include "storage.h"
+
+namespace chr::storage::internal {
+
+struct PackStorage : StorageI {
+  explicit PackStorage() = default;
+
+  PackStorage(const PackStorage&) = delete;
+  PackStorage(PackStorage&& other) noexcept
+      : archive_{std::move(other.archive_)} {}
+
+  PackStorage& operator=(const PackStorage&) = delete;
+  PackStorage& operator=(PackStorage&& other) noexcept = delete;
+
+  auto SetBasePath(std::string_view path) -> void;
+
+  auto GetEntries(std::string_view path) const -> std::vector<Entry>;
+  auto GetFile(std::string_view path, FileMode mode) const -> File;
+  auto GetNativePath(std::string_view /*path*/) const
+      -> std::filesystem::path {
+    return {};
+  }
+  auto GetEntry(std::string_view path) const -> std::optional<Entry>;
+  auto GetEntryById(PathId id) const -> std::optional<Entry>;
+  auto Refresh(std::string_view /*path*/) -> void {}
+  auto ReadMany(std::span<const ReadRequest> requests) const -> void;
+  auto GetStats() const -> StorageStats { return {}; }
+  auto SetBlockCache(std::shared_ptr<BlockCache> /*cache*/) -> void {}
+
+  static auto OpenFile(const std::shared_ptr<const PackArchive>& archive,
+                       const PackTocEntry* entry) -> File;
+
+ private:
+  auto MakeEntry(const PackTocEntry* toc_entry) const -> std::optional<Entry>;
+
+  std::shared_ptr<const PackArchive> archive_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_PACK_PACK_STORAGE_H_
@@ -0,0 +1,221 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "pack_writer.h"
+
+#include <fstream>
+#include <iterator>
+#include <set>
+
+#include "compression/chunked_data.h"
+#include "pack/pack_format.h"
+#include "path.h"
+
+namespace chr::storage {
+
+static auto AlignOffset(uint64_t offset, uint64_t alignment) -> uint64_t {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+auto PackWriter::AddFile(std::string_view path, std::vector<uint8_t> data,
+                         PackCompression compression) -> void {
+  CHR_ZONE_SCOPED();
+
+  if (compression == PackCompression::kLz) {
+    auto compressed = internal::CompressChunked(data);
+    if (compressed.size() < data.size()) {
+      files_.insert_or_assign(NormalizePath(path),
+                              FileData{std::move(compressed), true});
+      return;
+    }
+  }
+
+  files_.insert_or_assign(NormalizePath(path),
+                          FileData{std::move(data), false});
+}
+
+auto PackWriter::AddDirectory(const std::filesystem::path& directory,
+                              std::string_view path,
+                              PackCompression compression) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto base_path = NormalizePath(path);
+
+  for (const auto& dir_entry :
+       std::filesystem::recursive_directory_iterator{directory}) {
+    if (!dir_entry.is_regular_file()) {
+      continue;
+    }
+
+    auto relative_path =
+        dir_entry.path().lexically_relative(directory).generic_string();
+
+    std::vector<uint8_t> data(dir_entry.file_size());
+    std::ifstream file{};
+    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    file.open(dir_entry.path(), std::ios::binary);
+    file.read(std::bit_cast<char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+
+    AddFile(base_path + "/" + relative_path, std::move(data), compression);
+  }
+}
+
+auto PackWriter::SetFileOrder(const AccessTrace& trace) -> void {
+  file_order_.clear();
+
+  std::set<std::string, std::less<>> added{};
+  for (const auto& record : trace.records) {
+    if (auto path = NormalizePath(record.path); added.insert(path).second) {
+      file_order_.push_back(std::move(path));
+    }
+  }
+}
+
+auto PackWriter::Write(const std::filesystem::path& output) const -> void {
+  CHR_ZONE_SCOPED();
+
+  // Collect all the paths, parent directories included.
+  std::set<std::string, std::less<>> directories{"/"};
+  for (const auto& [path, file] : files_) {
+    for (auto parent = ParentPath(path); directories.emplace(parent).second;
+         parent = ParentPath(parent)) {
+    }
+  }
+
+  std::vector<std::string_view> paths{};
+  paths.reserve(directories.size() + files_.size());
+  for (const auto& directory : directories) {
+    if (files_.contains(directory)) {
+      throw std::runtime_error(
+          fmt::format("Path {} is both a file and a directory", directory));
+    }
+    paths.emplace_back(directory);
+  }
+  for (const auto& [path, file] : files_) {
+    paths.emplace_back(path);
+  }
+
+  // The table of contents is sorted by path identifier, so the entries can be
+  // found with a binary search.
+  std::ranges::sort(paths, {}, [](std::string_view path) {
+    return std::pair{HashPath(path), path};
+  });
+
+  for (size_t i = 1; i < paths.size(); i++) {
+    if (HashPath(paths[i - 1]) == HashPath(paths[i])) {
+      throw std::runtime_error(fmt::format("Hash collision between {} and {}",
+                                           paths[i - 1], paths[i]));
+    }
+  }
+
+  std::unordered_map<std::string_view, uint32_t> indices{};
+  for (uint32_t i = 0; i < paths.size(); i++) {
+    indices.try_emplace(paths[i], i);
+  }
+
+  // Children are listed in name order.
+  std::map<std::string_view, std::vector<uint32_t>> children_map{};
+  for (const auto& directory : directories) {
+    children_map.try_emplace(directory);
+  }
+  std::vector<std::string_view> sorted_paths{paths};
+  std::ranges::sort(sorted_paths);
+  for (auto path : sorted_paths) {
+    if (path != "/") {
+      children_map[ParentPath(path)].push_back(indices.at(path));
+    }
+  }
+
+  auto entry_count = static_cast<uint32_t>(paths.size());
+  auto children_count = entry_count - 1;
+  auto toc_offset = uint64_t{sizeof(internal::PackHeader)};
+  auto children_offset =
+      toc_offset + sizeof(internal::PackTocEntry) * entry_count;
+  auto strings_offset = children_offset + sizeof(uint32_t) * children_count;
+
+  internal::PackHeader header{.magic = internal::kPackMagic,
+                              .version = internal::kPackVersion,
+                              .entry_count = entry_count,
+                              .children_count = children_count,
+                              .toc_offset = toc_offset,
+                              .children_offset = children_offset,
+                              .strings_offset = strings_offset,
+                              .strings_size = 0};
+
+  std::vector<internal::PackTocEntry> toc(paths.size());
+  std::vector<uint32_t> children{};
+  std::string strings{};
+  children.reserve(header.children_count);
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    auto& entry = toc[i];
+    entry.path_id = HashPath(paths[i]);
+    entry.path_offset = static_cast<uint32_t>(strings.size());
+    entry.path_size = static_cast<uint32_t>(paths[i].size());
+    strings.append(paths[i]);
+
+    if (auto it = children_map.find(paths[i]); it != children_map.end()) {
+      entry.flags = internal::kPackEntryDirectory;
+      entry.offset = children.size();
+      entry.size = it->second.size();
+      children.insert(children.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  header.strings_size = strings.size();
+
+  // The data of the traced files comes first, in access order, then the
+  // other files in table of contents order.
+  std::vector<size_t> data_order{};
+  std::vector<bool> is_ordered(paths.size(), false);
+  data_order.reserve(files_.size());
+  for (const auto& path : file_order_) {
+    if (files_.contains(path)) {
+      data_order.push_back(indices.at(path));
+      is_ordered[indices.at(path)] = true;
+    }
+  }
+  for (size_t i = 0; i < paths.size(); i++) {
+    if ((toc[i].flags & internal::kPackEntryDirectory) == 0 &&
+        !is_ordered[i]) {
+      data_order.push_back(i);
+    }
+  }
+
+  auto data_offset = header.strings_offset + header.strings_size;
+  for (auto i : data_order) {
+    const auto& file = files_.find(paths[i])->second;
+    data_offset = AlignOffset(data_offset, internal::kPackDataAlignment);
+    toc[i].offset = data_offset;
+    toc[i].size = file.data.size();
+    if (file.is_compressed) {
+      toc[i].flags = internal::kPackEntryCompressed;
+    }
+    data_offset += file.data.size();
+  }
+
+  std::ofstream stream{};
+  stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  stream.open(output, std::ios::binary | std::ios::trunc);
+
+  stream.write(std::bit_cast<const char*>(&header), sizeof(header));
+  stream.write(std::bit_cast<const char*>(toc.data()),
+               static_cast<std::streamsize>(toc.size() *
+                                            sizeof(internal::PackTocEntry)));
+  stream.write(
+      std::bit_cast<const char*>(children.data()),
+      static_cast<std::streamsize>(children.size() * sizeof(uint32_t)));
+  stream.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+  for (auto i : data_order) {
+    const auto& data = files_.find(paths[i])->second.data;
+    auto padding = toc[i].offset - static_cast<uint64_t>(stream.tellp());
+    std::fill_n(std::ostreambuf_iterator<char>(stream), padding, '\0');
+    stream.write(std::bit_cast<const char*>(data.data()),
+                 static_cast<std::streamsize>(data.size()));
+  }
+}
+
+}  // namespace chr::storage
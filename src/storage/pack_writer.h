@@ -0,0 +1,67 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PACK_WRITER_H_
+#define CHR_STORAGE_PACK_WRITER_H_
+
+#include <filesystem>
+#include <map>
+
+#include "access_trace.h"
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Compression of the files stored in a pack.
+enum class PackCompression {
+  kNone,  //!< Files are stored as they are, they can be memory mapped.
+  kLz     //!< Files are split in chunks compressed with a fast LZ codec,
+          //!< reads decompress only the chunks they touch.
+};
+
+//! @brief Build pack files that can be read with the BackendType::kPack
+//!        storage backend.
+struct PackWriter {
+  //! @brief Add a file to the pack. The parent directories are added
+  //!        automatically.
+  //! @param path Path of the file inside the pack.
+  //! @param data File content.
+  //! @param compression How the file is stored. A compressed file that
+  //!                    doesn't get smaller is stored as it is.
+  auto AddFile(std::string_view path, std::vector<uint8_t> data,
+               PackCompression compression = PackCompression::kNone) -> void;
+
+  //! @brief Recursively add all the files from a directory of the local
+  //!        filesystem.
+  //! @param directory Directory to add.
+  //! @param path Path inside the pack where the directory content is added.
+  //! @param compression How the files are stored.
+  auto AddDirectory(const std::filesystem::path& directory,
+                    std::string_view path = "/",
+                    PackCompression compression = PackCompression::kNone)
+      -> void;
+
+  //! @brief Store the data of the files in the order they are accessed, so
+  //!        the reads of a run touch the pack sequentially. The files that
+  //!        are not in the trace are stored after them.
+  //! @param trace Access trace, see Storage::StopAccessTrace.
+  auto SetFileOrder(const AccessTrace& trace) -> void;
+
+  //! @brief Write the pack file.
+  //! @param output Path of the pack file to write.
+  auto Write(const std::filesystem::path& output) const -> void;
+
+ private:
+  struct FileData {
+    std::vector<uint8_t> data;
+    bool is_compressed;
+  };
+
+  std::map<std::string, FileData, std::less<>> files_{};
+  std::vector<std::string> file_order_{};
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_PACK_WRITER_H_
@@ -0,0 +1,124 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_PATH_H_
+#define CHR_STORAGE_PATH_H_
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Identifier of a storage path, see HashPath.
+using PathId = uint64_t;
+
+namespace internal {
+template <typename Fun>
+constexpr auto ForEachNormalizedChar(std::string_view path, Fun fun) -> void {
+  fun('/');
+
+  bool have_component = false;
+  bool need_separator = false;
+  for (auto c : path) {
+    if (c == '/') {
+      need_separator = have_component;
+      continue;
+    }
+
+    if (need_separator) {
+      fun('/');
+      need_separator = false;
+    }
+
+    fun(c);
+    have_component = true;
+  }
+}
+}  // namespace internal
+
+//! @brief Hash a storage path with the 64 bit FNV-1a function.
+//!        The path is normalized while it's hashed (see NormalizePath), so
+//!        "/shaders//triangle.vert/" and "shaders/triangle.vert" have the same
+//!        identifier. No memory is allocated.
+//! @param path Path to hash.
+//! @return Path identifier.
+constexpr auto HashPath(std::string_view path) -> PathId {
+  constexpr PathId kOffsetBasis = 14695981039346656037ULL;
+  constexpr PathId kPrime = 1099511628211ULL;
+
+  PathId hash = kOffsetBasis;
+  internal::ForEachNormalizedChar(path, [&hash](char c) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * kPrime;
+  });
+  return hash;
+}
+
+//! @brief Normalize a storage path. The normalized path always starts with a
+//!        slash, has no repeated slashes and no trailing slash. The root path
+//!        is "/".
+//! @param path Path to normalize.
+//! @return Normalized path.
+inline auto NormalizePath(std::string_view path) -> std::string {
+  std::string normalized{};
+  normalized.reserve(path.size() + 1);
+  internal::ForEachNormalizedChar(
+      path, [&normalized](char c) { normalized.push_back(c); });
+  return normalized;
+}
+
+//! @brief Check if a path, once normalized, is equal to an already normalized
+//!        path. No memory is allocated.
+//! @param normalized Normalized path.
+//! @param path Path to compare.
+//! @return True if the paths are the same, otherwise false.
+constexpr auto IsSamePath(std::string_view normalized, std::string_view path)
+    -> bool {
+  size_t index = 0;
+  bool same = true;
+  internal::ForEachNormalizedChar(path, [&](char c) {
+    same = same && index < normalized.size() && normalized[index] == c;
+    index++;
+  });
+  return same && index == normalized.size();
+}
+
+//! @brief Get the parent of a normalized path.
+//! @param path Normalized path.
+//! @return Parent path, the root path is the parent of itself.
+constexpr auto ParentPath(std::string_view path) -> std::string_view {
+  auto separator = path.rfind('/');
+  if (separator == std::string_view::npos || separator == 0) {
+    return "/";
+  }
+
+  return path.substr(0, separator);
+}
+
+//! @brief Get the last component of a normalized path.
+//! @param path Normalized path.
+//! @return File or directory name, empty for the root path.
+constexpr auto PathName(std::string_view path) -> std::string_view {
+  auto separator = path.rfind('/');
+  if (separator == std::string_view::npos) {
+    return path;
+  }
+
+  return path.substr(separator + 1);
+}
+
+//! @brief Get the extension of a file or directory name, with the same rules
+//!        of std::filesystem::path::extension.
+//! @param name File or directory name.
+//! @return Extension (dot included), or an empty string.
+constexpr auto PathExtension(std::string_view name) -> std::string_view {
+  auto dot = name.rfind('.');
+  if (dot == std::string_view::npos || dot == 0 || name == "..") {
+    return {};
+  }
+
+  return name.substr(dot);
+}
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_PATH_H_
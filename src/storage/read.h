@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_READ_H_
+#define CHR_STORAGE_READ_H_
+
+#include <span>
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Size value that indicate to read until the end of the file.
+constexpr size_t kWholeFile = std::numeric_limits<size_t>::max();
+
+//! @brief Range of bytes to read from a file.
+struct ReadRange {
+  //! @brief Offset of the first byte to read.
+  size_t offset{0};
+
+  //! @brief Number of bytes to read, kWholeFile to read until the end of the
+  //!        file.
+  size_t size{kWholeFile};
+};
+
+//! @brief Request of a batch read, see Storage::ReadMany.
+struct ReadRequest {
+  //! @brief Path of the file.
+  std::string_view path{};
+
+  //! @brief Offset of the first byte to read.
+  size_t offset{0};
+
+  //! @brief Where to store the data, its size is the number of bytes to read.
+  std::span<uint8_t> buffer{};
+};
+
+//! @brief Identifier of an asynchronous read request.
+using AsyncReadId = uint64_t;
+
+//! @brief Result of an asynchronous read request.
+struct AsyncReadResult {
+  //! @brief Identifier returned when the request was queued.
+  AsyncReadId id{0};
+
+  //! @brief Path of the file.
+  std::string path{};
+
+  //! @brief It's true if the data is read correctly.
+  bool success{false};
+
+  //! @brief Error message when the read has failed.
+  std::string error{};
+
+  //! @brief Data read from the file.
+  std::vector<uint8_t> data{};
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_READ_H_
@@ -0,0 +1,75 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_STATS_H_
+#define CHR_STORAGE_STATS_H_
+
+#include <array>
+#include <map>
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Number of buckets of the latency histograms.
+constexpr size_t kLatencyBucketCount = 16;
+
+//! @brief I/O counters of a storage.
+struct IoStats {
+  //! @brief Number of opened files.
+  uint64_t open_count{0};
+
+  //! @brief Number of reads (File::Read and File::ReadAt).
+  uint64_t read_count{0};
+
+  //! @brief Number of seeks.
+  uint64_t seek_count{0};
+
+  //! @brief Number of bytes read.
+  uint64_t bytes_read{0};
+
+  //! @brief Histogram of the read latencies. The bucket i counts the reads
+  //!        that took less than 2^i microseconds, the last bucket counts all
+  //!        the slower reads.
+  std::array<uint64_t, kLatencyBucketCount> read_latency{};
+
+  //! @brief Add the counters of other statistics.
+  //! @param other Statistics to add.
+  //! @return This object.
+  auto operator+=(const IoStats& other) -> IoStats& {
+    open_count += other.open_count;
+    read_count += other.read_count;
+    seek_count += other.seek_count;
+    bytes_read += other.bytes_read;
+    for (size_t i = 0; i < kLatencyBucketCount; i++) {
+      read_latency[i] += other.read_latency[i];
+    }
+    return *this;
+  }
+};
+
+//! @brief I/O statistics of a storage, see Storage::GetStats.
+struct StorageStats {
+  //! @brief Counters of all the files.
+  IoStats total{};
+
+  //! @brief Counters grouped by the first component of the file paths (ex.
+  //!        "/shaders"), the files in the root directory are under "/".
+  std::map<std::string, IoStats, std::less<>> prefixes{};
+
+  //! @brief Add the counters of other statistics.
+  //! @param other Statistics to add.
+  //! @return This object.
+  auto operator+=(const StorageStats& other) -> StorageStats& {
+    total += other.total;
+    for (const auto& [prefix, stats] : other.prefixes) {
+      prefixes[prefix] += stats;
+    }
+    return *this;
+  }
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_STATS_H_
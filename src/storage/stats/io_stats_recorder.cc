@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "io_stats_recorder.h"
+
+#include <bit>
+
+namespace chr::storage::internal {
+
+// Process wide totals, plotted in Tracy.
+[[maybe_unused]] static std::atomic<uint64_t> g_plot_bytes_read{0};
+[[maybe_unused]] static std::atomic<uint64_t> g_plot_open_count{0};
+
+auto IoCounters::Load() const -> IoStats {
+  IoStats stats{};
+  stats.open_count = open_count.load(std::memory_order_relaxed);
+  stats.read_count = read_count.load(std::memory_order_relaxed);
+  stats.seek_count = seek_count.load(std::memory_order_relaxed);
+  stats.bytes_read = bytes_read.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kLatencyBucketCount; i++) {
+    stats.read_latency[i] = read_latency[i].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+auto IoStatsRecorder::GetCounters(std::string_view path) -> IoCounters* {
+  // The prefix is the first component of the path. It's found without
+  // normalizing the path, so the files are opened without allocations.
+  std::string_view prefix{};
+  auto begin = path.find_first_not_of('/');
+  if (begin != std::string_view::npos) {
+    auto separator = path.find('/', begin);
+    if (separator != std::string_view::npos &&
+        path.find_first_not_of('/', separator) != std::string_view::npos) {
+      prefix = path.substr(begin, separator - begin);
+    }
+  }
+
+  // The prefixes are added once, the following lookups share the lock.
+  {
+    std::shared_lock lock{mutex_};
+    if (auto it = prefixes_.find(prefix); it != prefixes_.end()) {
+      return it->second.get();
+    }
+  }
+
+  std::scoped_lock lock{mutex_};
+  auto [it, inserted] = prefixes_.try_emplace(std::string{prefix});
+  if (inserted) {
+    it->second = std::make_unique<IoCounters>();
+  }
+
+  return it->second.get();
+}
+
+auto IoStatsRecorder::GetStats() const -> StorageStats {
+  StorageStats stats{};
+  stats.total = total_.Load();
+
+  std::shared_lock lock{mutex_};
+  for (const auto& [prefix, counters] : prefixes_) {
+    stats.prefixes.emplace("/" + prefix, counters->Load());
+  }
+
+  return stats;
+}
+
+auto IoStatsRecorder::RecordOpen(IoCounters& prefix) -> void {
+  total_.open_count.fetch_add(1, std::memory_order_relaxed);
+  prefix.open_count.fetch_add(1, std::memory_order_relaxed);
+
+  CHR_PLOT("Storage opened files",
+           static_cast<int64_t>(
+               g_plot_open_count.fetch_add(1, std::memory_order_relaxed) + 1));
+}
+
+auto IoStatsRecorder::RecordSeek(IoCounters& prefix) -> void {
+  total_.seek_count.fetch_add(1, std::memory_order_relaxed);
+  prefix.seek_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto IoStatsRecorder::RecordRead(IoCounters& prefix, size_t size,
+                                 std::chrono::steady_clock::duration latency)
+    -> void {
+  auto microseconds = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  auto bucket = std::min<size_t>(std::bit_width(microseconds),
+                                 kLatencyBucketCount - 1);
+
+  for (auto* counters : {&total_, &prefix}) {
+    counters->read_count.fetch_add(1, std::memory_order_relaxed);
+    counters->bytes_read.fetch_add(size, std::memory_order_relaxed);
+    counters->read_latency[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  CHR_PLOT("Storage bytes read",
+           static_cast<int64_t>(
+               g_plot_bytes_read.fetch_add(size, std::memory_order_relaxed) +
+               size));
+  CHR_PLOT("Storage read latency (us)", static_cast<int64_t>(microseconds));
+}
+
+}  // namespace chr::storage::internal
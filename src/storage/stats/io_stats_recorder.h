@@ -0,0 +1,99 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_STATS_IO_STATS_RECORDER_H_
+#define CHR_STORAGE_STATS_IO_STATS_RECORDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+
+#include "pch.h"
+#include "stats.h"
+
+namespace chr::storage::internal {
+
+struct IoCounters {
+  std::atomic<uint64_t> open_count{0};
+  std::atomic<uint64_t> read_count{0};
+  std::atomic<uint64_t> seek_count{0};
+  std::atomic<uint64_t> bytes_read{0};
+  std::array<std::atomic<uint64_t>, kLatencyBucketCount> read_latency{};
+
+  auto Load() const -> IoStats;
+};
+
+// Collect the I/O statistics of a storage. The counters are atomic, so the
+// files can update them from any thread without locks.
+struct IoStatsRecorder {
+  explicit IoStatsRecorder() = default;
+
+  IoStatsRecorder(const IoStatsRecorder&) = delete;
+  IoStatsRecorder(IoStatsRecorder&& other) noexcept = delete;
+
+  IoStatsRecorder& operator=(const IoStatsRecorder&) = delete;
+  IoStatsRecorder& operator=(IoStatsRecorder&& other) noexcept = delete;
+
+  auto GetCounters(std::string_view path) -> IoCounters*;
+  auto GetStats() const -> StorageStats;
+
+  auto RecordOpen(IoCounters& prefix) -> void;
+  auto RecordSeek(IoCounters& prefix) -> void;
+  auto RecordRead(IoCounters& prefix, size_t size,
+                  std::chrono::steady_clock::duration latency) -> void;
+
+ private:
+  mutable std::shared_mutex mutex_{};
+  IoCounters total_{};
+
+  // Counters by first path component, without the leading slash. The files
+  // at the root have an empty prefix.
+  std::map<std::string, std::unique_ptr<IoCounters>, std::less<>> prefixes_{};
+};
+
+// Handle used by the files to update the counters of their storage.
+struct IoStatsProbe {
+  std::shared_ptr<IoStatsRecorder> recorder{};
+  IoCounters* prefix{nullptr};
+
+  auto RecordOpen() const -> void {
+    if (recorder != nullptr) {
+      recorder->RecordOpen(*prefix);
+    }
+  }
+
+  auto RecordSeek() const -> void {
+    if (recorder != nullptr) {
+      recorder->RecordSeek(*prefix);
+    }
+  }
+
+  // Run a read and record its size and latency.
+  template <typename Fun>
+  auto Read(size_t size, Fun fun) const -> void {
+    auto start = std::chrono::steady_clock::now();
+    fun();
+    if (recorder != nullptr) {
+      recorder->RecordRead(*prefix, size,
+                           std::chrono::steady_clock::now() - start);
+    }
+  }
+
+  // Run a read that returns the number of bytes read, and record it.
+  template <typename Fun>
+  auto ReadSome(Fun fun) const -> size_t {
+    auto start = std::chrono::steady_clock::now();
+    auto size = fun();
+    if (recorder != nullptr) {
+      recorder->RecordRead(*prefix, size,
+                           std::chrono::steady_clock::now() - start);
+    }
+    return size;
+  }
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_STATS_IO_STATS_RECORDER_H_
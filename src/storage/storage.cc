@@ -4,16 +4,193 @@
 
 #include "storage.h"
 
+#include <system_error>
+
+#include "async/async_reader.h"
 #include "filesystem/filesystem_storage.h"
+#include "manifest/manifest_builder.h"
+#include "memory/memory_storage.h"
+#include "overlay/overlay_storage.h"
+#include "pack/pack_storage.h"
+#include "trace/access_recorder.h"
+#include "trace/prefetcher.h"
+#include "watch/inotify_watcher.h"
 
 namespace chr::storage {
 
-Storage::Storage(BackendType type) {
+Storage::Storage(BackendType type) : type_{type} {
   if (type == BackendType::kFileSystem) {
     storage_.emplace<internal::FilesystemStorage>();
+  } else if (type == BackendType::kPack) {
+    storage_.emplace<internal::PackStorage>();
+  } else if (type == BackendType::kOverlay) {
+    storage_.emplace<internal::OverlayStorage>();
+  } else if (type == BackendType::kMemory) {
+    storage_.emplace<internal::MemoryStorage>();
   } else {
     debug::Assert(false, "Invalid storage backend type");
   }
 }
 
+Storage::Storage(Storage &&other) noexcept
+    : type_{other.type_},
+      storage_{std::move(other.storage_)},
+      async_reader_{std::move(other.async_reader_)},
+      watcher_{std::move(other.watcher_)},
+      recorder_{std::move(other.recorder_)},
+      prefetcher_{std::move(other.prefetcher_)} {}
+
+Storage::~Storage() = default;
+
+auto Storage::Mount(Storage storage, int32_t priority) -> void {
+  if (type_ != BackendType::kOverlay) {
+    throw std::logic_error("Storages can be mounted only in overlays");
+  }
+
+  GetNativeType<internal::OverlayStorage>().Mount(std::move(storage),
+                                                  priority);
+}
+
+auto Storage::GetFile(std::string_view path, FileMode mode) const -> File {
+  if (recorder_ != nullptr) {
+    recorder_->Record(path, {});
+  }
+
+  return storage_->GetFile(path, mode);
+}
+
+auto Storage::ReadMany(std::span<const ReadRequest> requests) const -> void {
+  if (recorder_ != nullptr) {
+    for (const auto &request : requests) {
+      recorder_->Record(request.path, {.offset = request.offset,
+                                       .size = request.buffer.size()});
+    }
+  }
+
+  storage_->ReadMany(requests);
+}
+
+auto Storage::AddFile(std::string_view path, std::vector<uint8_t> data)
+    -> void {
+  if (type_ != BackendType::kMemory) {
+    throw std::logic_error("Files can be added only to memory storages");
+  }
+
+  GetNativeType<internal::MemoryStorage>().AddFile(path, std::move(data));
+}
+
+auto Storage::AddFiles(const Storage &storage, std::string_view path) -> void {
+  if (type_ != BackendType::kMemory) {
+    throw std::logic_error("Files can be added only to memory storages");
+  }
+
+  GetNativeType<internal::MemoryStorage>().AddFiles(storage, path);
+}
+
+auto Storage::BuildManifest(std::string_view path, bool hash_content) const
+    -> Manifest {
+  internal::ManifestBuilder builder{*this, hash_content};
+  return builder.Build(path);
+}
+
+auto Storage::ReadAsync(std::string_view path, ReadRange range)
+    -> AsyncReadId {
+  CHR_ZONE_SCOPED();
+
+  if (async_reader_ == nullptr) {
+    async_reader_ = std::make_unique<internal::AsyncReader>();
+  }
+
+  if (recorder_ != nullptr) {
+    recorder_->Record(path, range);
+  }
+
+  return async_reader_->Submit(
+      std::string{path}, GetNativePath(path),
+      [this, path] { return storage_->GetFile(path, FileMode::kStream); },
+      range);
+}
+
+auto Storage::PollAsyncReads() -> std::vector<AsyncReadResult> {
+  if (async_reader_ == nullptr) {
+    return {};
+  }
+
+  return async_reader_->Poll();
+}
+
+auto Storage::WaitAsyncReads() -> void {
+  if (async_reader_ != nullptr) {
+    async_reader_->Wait();
+  }
+}
+
+auto Storage::StartAccessTrace() -> void {
+  if (recorder_ == nullptr) {
+    recorder_ = std::make_unique<internal::AccessRecorder>();
+  }
+}
+
+auto Storage::StopAccessTrace() -> AccessTrace {
+  if (recorder_ == nullptr) {
+    return {};
+  }
+
+  auto trace = recorder_->TakeTrace();
+  recorder_.reset();
+  return trace;
+}
+
+auto Storage::Prefetch(const AccessTrace &trace) -> void {
+  CHR_ZONE_SCOPED();
+
+  prefetcher_.reset();
+
+  // Paths are resolved here, the background thread only does the I/O and
+  // never touches the backend.
+  std::vector<internal::PrefetchItem> items{};
+  items.reserve(trace.records.size());
+  for (const auto &record : trace.records) {
+    auto &item = items.emplace_back();
+    item.native_path = storage_->GetNativePath(record.path);
+    item.range = record.range;
+    if (item.native_path.empty()) {
+      item.file = storage_->GetFile(record.path, FileMode::kStream);
+    }
+  }
+
+  prefetcher_ = std::make_unique<internal::Prefetcher>(std::move(items));
+}
+
+auto Storage::Watch() -> void {
+  CHR_ZONE_SCOPED();
+
+  if (watcher_ != nullptr) {
+    return;
+  }
+
+  auto native_path = GetNativePath("/");
+  if (native_path.empty()) {
+    throw std::system_error(std::make_error_code(std::errc::not_supported),
+                            "The storage is not on the local filesystem");
+  }
+
+  watcher_ = std::make_unique<internal::InotifyWatcher>(native_path);
+}
+
+auto Storage::PollChanges() -> std::vector<StorageChange> {
+  CHR_ZONE_SCOPED();
+
+  if (watcher_ == nullptr) {
+    return {};
+  }
+
+  auto changes = watcher_->Poll();
+  for (const auto &change : changes) {
+    Refresh(change.path);
+  }
+
+  return changes;
+}
+
 }  // namespace chr::storage
@@ -5,14 +5,24 @@
 #ifndef CHR_STORAGE_STORAGE_H_
 #define CHR_STORAGE_STORAGE_H_
 
+#include <filesystem>
+#include <optional>
+
+#include "access_trace.h"
+#include "block_cache.h"
 #include "entry.h"
 #include "file.h"
+#include "manifest.h"
+#include "path.h"
 #include "pch.h"
+#include "read.h"
+#include "stats.h"
+#include "watch.h"
 
 namespace chr::storage {
 
 namespace internal {
-constexpr size_t kStorageSize = 40;
+constexpr size_t kStorageSize = 48;
 
 struct StorageI : entt::type_list<> {
   template <typename Base>
@@ -23,23 +33,55 @@ struct StorageI : entt::type_list<> {
     auto GetEntries(std::string_view path) const -> std::vector<Entry> {
       return this->template invoke<1>(*this, path);
     }
-    auto GetFile(std::string_view path) const -> File {
-      return this->template invoke<2>(*this, path);
+    auto GetFile(std::string_view path, FileMode mode) const -> File {
+      return this->template invoke<2>(*this, path, mode);
+    }
+    auto GetNativePath(std::string_view path) const -> std::filesystem::path {
+      return this->template invoke<3>(*this, path);
+    }
+    auto GetEntry(std::string_view path) const -> std::optional<Entry> {
+      return this->template invoke<4>(*this, path);
+    }
+    auto GetEntryById(PathId id) const -> std::optional<Entry> {
+      return this->template invoke<5>(*this, id);
+    }
+    auto Refresh(std::string_view path) -> void {
+      this->template invoke<6>(*this, path);
+    }
+    auto GetStats() const -> StorageStats {
+      return this->template invoke<7>(*this);
+    }
+    auto ReadMany(std::span<const ReadRequest> requests) const -> void {
+      this->template invoke<8>(*this, requests);
+    }
+    auto SetBlockCache(std::shared_ptr<BlockCache> cache) -> void {
+      this->template invoke<9>(*this, std::move(cache));
     }
   };
 
   template <typename Type>
-  using impl =
-      entt::value_list<&Type::SetBasePath, &Type::GetEntries, &Type::GetFile>;
+  using impl = entt::value_list<&Type::SetBasePath, &Type::GetEntries,
+                                &Type::GetFile, &Type::GetNativePath,
+                                &Type::GetEntry, &Type::GetEntryById,
+                                &Type::Refresh, &Type::GetStats,
+                                &Type::ReadMany, &Type::SetBlockCache>;
 };
 
 template <typename T>
 concept ConceptStorage = std::is_base_of_v<StorageI, T>;
+
+struct AccessRecorder;
+struct AsyncReader;
+struct InotifyWatcher;
+struct Prefetcher;
 }  // namespace internal
 
 //! @brief Storage backend type.
 enum class BackendType {
-  kFileSystem  //!< Local file system.
+  kFileSystem,  //!< Local file system.
+  kPack,        //!< Pack file, see PackWriter.
+  kOverlay,     //!< Union of other storages, see Storage::Mount.
+  kMemory       //!< Files held in memory, see Storage::AddFile.
 };
 
 //! @brief Handle a storage backend for I/O operations on files.
@@ -52,16 +94,21 @@ struct Storage {
   Storage(const Storage &) = delete;
 
   //! @brief Move constructor.
-  Storage(Storage &&other) noexcept : storage_{std::move(other.storage_)} {}
+  Storage(Storage &&other) noexcept;
 
-  ~Storage() = default;
+  ~Storage();
 
   //! @brief The copy assignment operator is not supported.
   Storage &operator=(const Storage &) = delete;
 
   //! @brief Move assignment operator.
   Storage &operator=(Storage &&other) noexcept {
+    std::swap(type_, other.type_);
     std::swap(storage_, other.storage_);
+    std::swap(async_reader_, other.async_reader_);
+    std::swap(watcher_, other.watcher_);
+    std::swap(recorder_, other.recorder_);
+    std::swap(prefetcher_, other.prefetcher_);
     return *this;
   }
 
@@ -69,6 +116,9 @@ struct Storage {
   //!        change based on the backend type.
   //!        For local filesystem indicate the root path where the files are
   //!        located.
+  //!        For pack files indicate the path of the pack file to load.
+  //!        For overlays and memory storages it has no effect, see Mount
+  //!        and AddFile.
   //! @param path Base path to set.
   auto SetBasePath(std::string_view path) -> void {
     storage_->SetBasePath(path);
@@ -81,20 +131,185 @@ struct Storage {
     return storage_->GetEntries(path);
   }
 
+  //! @brief Get the entry for a given path. The backend keeps an index of
+  //!        the known paths, so repeated lookups don't access the disk and
+  //!        don't allocate memory.
+  //! @param path Entry path.
+  //! @return The entry, or an empty optional if the path doesn't exist.
+  auto GetEntry(std::string_view path) const -> std::optional<Entry> {
+    return storage_->GetEntry(path);
+  }
+
+  //! @brief Get the entry for a given path identifier, see HashPath.
+  //! @param id Path identifier.
+  //! @return The entry, or an empty optional if the path doesn't exist.
+  auto GetEntry(PathId id) const -> std::optional<Entry> {
+    return storage_->GetEntryById(id);
+  }
+
   //! @brief Get a file from a given path.
   //! @param path File path.
+  //! @param mode How the file will be accessed.
   //! @return File object.
-  auto GetFile(std::string_view path) const -> File {
-    return storage_->GetFile(path);
+  auto GetFile(std::string_view path, FileMode mode = FileMode::kStream) const
+      -> File;
+
+  //! @brief Get the path on the local filesystem of a file.
+  //! @param path File path.
+  //! @return Local filesystem path, or an empty path if the backend doesn't
+  //!         serve the file from a local file (ex. pack files).
+  auto GetNativePath(std::string_view path) const -> std::filesystem::path {
+    return storage_->GetNativePath(path);
   }
 
+  //! @brief Drop the metadata that the backend keeps about a path, so the
+  //!        next lookups see the changes made to it on the disk. It's called
+  //!        by PollChanges for every reported path.
+  //!        It must not be called concurrently with the other methods.
+  //! @param path Changed path.
+  auto Refresh(std::string_view path) -> void { storage_->Refresh(path); }
+
+  //! @brief Read many ranges of data, possibly from many files, in a single
+  //!        batch. The requests are sorted by file and offset, every file is
+  //!        opened once and the contiguous ranges of a local file are read
+  //!        with a single scatter-gather system call (preadv). Pack files are
+  //!        read in the order of the data in the pack.
+  //!        An exception is thrown if a file is missing or a range is past
+  //!        the end of its file, the content of the buffers is undefined.
+  //! @param requests Ranges to read.
+  auto ReadMany(std::span<const ReadRequest> requests) const -> void;
+
+  //! @brief Scan a directory and its subdirectories and collect the files in a
+  //!        manifest, with their sizes, modification times and content
+  //!        hashes. The directories are scanned in parallel on a thread
+  //!        pool, every file is hashed by the task that finds it.
+  //! @param path Directory to scan, by default the whole storage.
+  //! @param hash_content Hash the content of the files, it reads all of them.
+  //! @return Manifest of the scanned files.
+  auto BuildManifest(std::string_view path = "/",
+                     bool hash_content = true) const -> Manifest;
+
+  //! @brief Get the I/O statistics of the files opened from the storage.
+  //!        Only the local filesystem backend collects them, the overlays
+  //!        report the sum of the mounted storages.
+  //! @return Storage statistics.
+  auto GetStats() const -> StorageStats { return storage_->GetStats(); }
+
+  //! @brief Read the small reads of local files through a block cache, so
+  //!        repeated reads of the same data (headers, tables of contents,
+  //!        shader includes) don't go to the operating system. The same
+  //!        cache can be set on many storages, the overlays set it on all
+  //!        the mounted storages. Only the files opened with
+  //!        FileMode::kStream after the call use it, pack files and memory
+  //!        storages are already served from memory.
+  //! @param cache Cache to use, or nullptr to disable it.
+  auto SetBlockCache(std::shared_ptr<BlockCache> cache) -> void {
+    storage_->SetBlockCache(std::move(cache));
+  }
+
+  //! @brief Mount a storage in an overlay (BackendType::kOverlay). The paths
+  //!        of every mounted storage are merged, when a path exists in more
+  //!        than one storage the one with the highest priority wins (the last
+  //!        mounted one with the same priority). A file hides a directory
+  //!        with the same path in the storages below it.
+  //!        The merged paths are indexed when the storage is mounted, so
+  //!        lookups don't depend on the number of mounted storages. Files
+  //!        added to a mounted storage later are not visible in the overlay.
+  //!        It must not be called concurrently with the other methods.
+  //! @param storage Storage to mount.
+  //! @param priority Priority of the storage.
+  //! @exception std::logic_error The storage is not an overlay.
+  auto Mount(Storage storage, int32_t priority = 0) -> void;
+
+  //! @brief Add a file to a memory storage (BackendType::kMemory). The
+  //!        storage takes the ownership of the content, files opened from it
+  //!        are served directly from that buffer (File::Map doesn't copy) in
+  //!        every FileMode. Missing parent directories are created, an
+  //!        existing file with the same path is replaced (files that are
+  //!        already open keep the old content).
+  //! @param path File path.
+  //! @param data File content.
+  //! @exception std::logic_error The storage is not a memory storage.
+  auto AddFile(std::string_view path, std::vector<uint8_t> data) -> void;
+
+  //! @brief Copy in a memory storage (BackendType::kMemory) all the files
+  //!        from another storage, with the same paths. It's useful to take
+  //!        the disk out of tests and benchmarks.
+  //! @param storage Storage to copy.
+  //! @param path Directory to copy, by default the whole storage.
+  //! @exception std::logic_error The storage is not a memory storage.
+  auto AddFiles(const Storage &storage, std::string_view path = "/") -> void;
+
+  //! @brief Queue a read that is executed without blocking the calling
+  //!        thread. Local files are read with io_uring where it's available
+  //!        (many reads in flight and one system call for every batch),
+  //!        otherwise the reads are executed on a pool of worker threads.
+  //! @param path File path.
+  //! @param range Range of bytes to read, by default the whole file.
+  //! @return Identifier of the request, it's reported back in the result.
+  auto ReadAsync(std::string_view path, ReadRange range = {}) -> AsyncReadId;
+
+  //! @brief Collect the results of the completed asynchronous reads. The
+  //!        requests queued since the last call are submitted too, so it's
+  //!        intended to be called once per frame.
+  //! @return Results of the completed reads.
+  auto PollAsyncReads() -> std::vector<AsyncReadResult>;
+
+  //! @brief Block until all the queued asynchronous reads are completed. The
+  //!        results still need to be collected with PollAsyncReads.
+  auto WaitAsyncReads() -> void;
+
+  //! @brief Start recording the files accessed through GetFile, ReadMany and
+  //!        ReadAsync (the files opened from an Entry are not recorded).
+  auto StartAccessTrace() -> void;
+
+  //! @brief Stop recording the accessed files.
+  //! @return Files accessed since StartAccessTrace, in the order of the first
+  //!         access. It can be saved and replayed with Prefetch on the next
+  //!         run, or used to sort the files of a pack (see
+  //!         PackWriter::SetFileOrder).
+  auto StopAccessTrace() -> AccessTrace;
+
+  //! @brief Replay an access trace on a background thread, so the data is in
+  //!        the page cache before it's requested. Local files are read ahead
+  //!        by the kernel (posix_fadvise on Linux), the others are read
+  //!        through the storage. A prefetch already running is stopped.
+  //! @param trace Trace to replay.
+  auto Prefetch(const AccessTrace &trace) -> void;
+
+  //! @brief Start watching the storage for changes made on the disk. Only
+  //!        the storages served from a local directory can be watched, with
+  //!        inotify on Linux. A std::system_error is thrown when it's not
+  //!        supported.
+  auto Watch() -> void;
+
+  //! @brief Collect the changes since the last call, merged by path (a file
+  //!        written many times is reported once, a file created and removed
+  //!        is not reported). The cached metadata of the changed paths is
+  //!        refreshed, see Refresh. It's intended to be called once per
+  //!        frame, so only the changed assets are reloaded. When the kernel
+  //!        drops the events the root path is reported as modified.
+  //!        It must not be called concurrently with the other methods.
+  //! @return Changed paths, empty if the storage is not watched.
+  auto PollChanges() -> std::vector<StorageChange>;
+
  private:
   template <internal::ConceptStorage Type>
   auto GetNativeType() const -> const Type & {
     return *static_cast<const Type *>(storage_.data());
   }
 
+  template <internal::ConceptStorage Type>
+  auto GetNativeType() -> Type & {
+    return *static_cast<Type *>(storage_.data());
+  }
+
+  BackendType type_;
   entt::basic_poly<internal::StorageI, internal::kStorageSize> storage_{};
+  std::unique_ptr<internal::AsyncReader> async_reader_{};
+  std::unique_ptr<internal::InotifyWatcher> watcher_{};
+  std::unique_ptr<internal::AccessRecorder> recorder_{};
+  std::unique_ptr<internal::Prefetcher> prefetcher_{};
 };
 
 }  // namespace chr::storage
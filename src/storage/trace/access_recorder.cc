@@ -0,0 +1,28 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "access_recorder.h"
+
+#include "path.h"
+
+namespace chr::storage::internal {
+
+auto AccessRecorder::Record(std::string_view path, ReadRange range) -> void {
+  auto normalized = NormalizePath(path);
+
+  // Only the first access to a range is kept, the trace is the order in
+  // which the data is needed.
+  std::scoped_lock lock{mutex_};
+  if (recorded_.emplace(normalized, range.offset, range.size).second) {
+    trace_.records.push_back({.path = std::move(normalized), .range = range});
+  }
+}
+
+auto AccessRecorder::TakeTrace() -> AccessTrace {
+  std::scoped_lock lock{mutex_};
+  recorded_.clear();
+  return std::exchange(trace_, {});
+}
+
+}  // namespace chr::storage::internal
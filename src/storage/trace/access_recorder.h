@@ -0,0 +1,36 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_TRACE_ACCESS_RECORDER_H_
+#define CHR_STORAGE_TRACE_ACCESS_RECORDER_H_
+
+#include <mutex>
+#include <set>
+
+#include "access_trace.h"
+#include "pch.h"
+
+namespace chr::storage::internal {
+
+struct AccessRecorder {
+  explicit AccessRecorder() = default;
+
+  AccessRecorder(const AccessRecorder&) = delete;
+  AccessRecorder(AccessRecorder&& other) noexcept = delete;
+
+  AccessRecorder& operator=(const AccessRecorder&) = delete;
+  AccessRecorder& operator=(AccessRecorder&& other) noexcept = delete;
+
+  auto Record(std::string_view path, ReadRange range) -> void;
+  auto TakeTrace() -> AccessTrace;
+
+ private:
+  std::mutex mutex_{};
+  AccessTrace trace_{};
+  std::set<std::tuple<std::string, size_t, size_t>, std::less<>> recorded_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_TRACE_ACCESS_RECORDER_H_
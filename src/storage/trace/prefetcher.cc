@@ -0,0 +1,110 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "prefetcher.h"
+
+#if defined(CHR_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <system_error>
+#else
+#include "filesystem/native_file.h"
+#endif
+
+namespace chr::storage::internal {
+
+// Size of the reads used to bring the data in memory.
+constexpr size_t kPrefetchChunkSize = 256 * 1024;
+
+Prefetcher::Prefetcher(std::vector<PrefetchItem> items)
+    : items_{std::move(items)},
+      thread_{[this](const std::stop_token& stop_token) { Run(stop_token); }} {
+}
+
+auto Prefetcher::Run(const std::stop_token& stop_token) -> void {
+  CHR_ZONE_SCOPED();
+
+  for (auto& item : items_) {
+    if (stop_token.stop_requested()) {
+      break;
+    }
+
+    try {
+      if (item.file) {
+        Touch(*item.file, item.range);
+      } else {
+        Advise(item.native_path, item.range);
+      }
+    } catch (const std::exception& e) {
+      // A trace can be older than the assets, missing files are expected.
+      log::Debug("Prefetch of {} skipped: {}", item.native_path.string(),
+                 e.what());
+    }
+  }
+
+  done_ = true;
+}
+
+#if defined(CHR_PLATFORM_LINUX)
+
+auto Prefetcher::Advise(const std::filesystem::path& native_path,
+                        ReadRange range) -> void {
+  CHR_ZONE_SCOPED();
+
+  auto fd = open(native_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to open file");
+  }
+
+  // The kernel starts reading the range in the page cache and returns
+  // immediately, a zero length means until the end of the file.
+  auto size = range.size == kWholeFile ? 0 : range.size;
+  posix_fadvise(fd, static_cast<off_t>(range.offset), static_cast<off_t>(size),
+                POSIX_FADV_WILLNEED);
+  close(fd);
+}
+
+#else
+
+auto Prefetcher::Advise(const std::filesystem::path& native_path,
+                        ReadRange range) -> void {
+  CHR_ZONE_SCOPED();
+
+  NativeFile file{};
+  file.Open(native_path);
+
+  auto size = file.Size();
+  auto end = range.size == kWholeFile
+                 ? size
+                 : std::min(size, range.offset + range.size);
+
+  std::vector<uint8_t> buffer(kPrefetchChunkSize);
+  for (auto offset = range.offset; offset < end; offset += buffer.size()) {
+    file.ReadAt(offset, buffer.data(), std::min(buffer.size(), end - offset));
+  }
+}
+
+#endif
+
+auto Prefetcher::Touch(File& file, ReadRange range) -> void {
+  CHR_ZONE_SCOPED();
+
+  file.Open();
+  file.Seek(0, SeekDir::kEnd);
+  auto size = file.Position();
+  auto end = range.size == kWholeFile
+                 ? size
+                 : std::min(size, range.offset + range.size);
+
+  std::vector<uint8_t> buffer(kPrefetchChunkSize);
+  for (auto offset = range.offset; offset < end; offset += buffer.size()) {
+    file.ReadAt(offset, buffer.data(), std::min(buffer.size(), end - offset));
+  }
+
+  file.Close();
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_TRACE_PREFETCHER_H_
+#define CHR_STORAGE_TRACE_PREFETCHER_H_
+
+#include <filesystem>
+#include <optional>
+#include <thread>
+
+#include "file.h"
+#include "pch.h"
+#include "read.h"
+
+namespace chr::storage::internal {
+
+// Range to prefetch. Local files are prefetched by path, so the kernel reads
+// them ahead, the others (pack files, etc.) are read through the file object.
+struct PrefetchItem {
+  std::filesystem::path native_path{};
+  std::optional<File> file{};
+  ReadRange range{};
+};
+
+// Replay an access trace on a background thread, so the data is in the page
+// cache when the main thread needs it.
+struct Prefetcher {
+  explicit Prefetcher(std::vector<PrefetchItem> items);
+
+  Prefetcher(const Prefetcher&) = delete;
+  Prefetcher(Prefetcher&& other) noexcept = delete;
+
+  ~Prefetcher() = default;
+
+  Prefetcher& operator=(const Prefetcher&) = delete;
+  Prefetcher& operator=(Prefetcher&& other) noexcept = delete;
+
+  auto IsDone() const -> bool { return done_; }
+
+ private:
+  auto Run(const std::stop_token& stop_token) -> void;
+
+  static auto Advise(const std::filesystem::path& native_path,
+                     ReadRange range) -> void;
+  static auto Touch(File& file, ReadRange range) -> void;
+
+  std::vector<PrefetchItem> items_;
+  std::atomic<bool> done_{false};
+
+  // Declared last, so the thread is stopped before anything else is
+  // destroyed.
+  std::jthread thread_;
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_TRACE_PREFETCHER_H_
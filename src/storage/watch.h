@@ -0,0 +1,30 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_WATCH_H_
+#define CHR_STORAGE_WATCH_H_
+
+#include "pch.h"
+
+namespace chr::storage {
+
+//! @brief Type of change of a storage path.
+enum class ChangeType {
+  kAdded,     //!< The path has been created.
+  kModified,  //!< The content of the path has been changed.
+  kRemoved    //!< The path has been deleted.
+};
+
+//! @brief Change of a storage path, see Storage::PollChanges.
+struct StorageChange {
+  //! @brief Type of change.
+  ChangeType type{ChangeType::kModified};
+
+  //! @brief Normalized path, see NormalizePath.
+  std::string path{};
+};
+
+}  // namespace chr::storage
+
+#endif  // CHR_STORAGE_WATCH_H_
@@ -0,0 +1,213 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include "inotify_watcher.h"
+
+#include <system_error>
+
+#if defined(CHR_PLATFORM_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#endif
+
+namespace chr::storage::internal {
+
+#if defined(CHR_PLATFORM_LINUX)
+
+constexpr uint32_t kInotifyWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY |
+                                       IN_CLOSE_WRITE | IN_MOVED_FROM |
+                                       IN_MOVED_TO | IN_ONLYDIR;
+
+// Size of the buffer for the events read with a single system call.
+constexpr size_t kInotifyBufferSize = 16 * 1024;
+
+InotifyWatcher::InotifyWatcher(std::filesystem::path base_path)
+    : base_path_{std::move(base_path)} {
+  CHR_ZONE_SCOPED();
+
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Failed to create inotify instance");
+  }
+
+  AddWatch("/", false);
+}
+
+InotifyWatcher::~InotifyWatcher() { close(fd_); }
+
+auto InotifyWatcher::IsSupported() -> bool { return true; }
+
+auto InotifyWatcher::Poll() -> std::vector<StorageChange> {
+  CHR_ZONE_SCOPED();
+
+  alignas(inotify_event) std::array<char, kInotifyBufferSize> buffer{};
+  while (true) {
+    auto size = read(fd_, buffer.data(), buffer.size());
+    if (size == -1 && errno == EINTR) {
+      continue;
+    }
+
+    if (size == -1 && errno == EAGAIN) {
+      break;
+    }
+
+    if (size == -1) {
+      throw std::system_error(errno, std::generic_category(),
+                              "Failed to read inotify events");
+    }
+
+    for (ssize_t offset = 0; offset < size;) {
+      const auto* event =
+          reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        log::Warn("Too many changes, the whole storage is reported modified");
+        Report(ChangeType::kModified, "/");
+        continue;
+      }
+
+      auto it = watches_.find(event->wd);
+      if (it == watches_.end()) {
+        continue;
+      }
+
+      if ((event->mask & IN_IGNORED) != 0) {
+        watches_.erase(it);
+        continue;
+      }
+
+      // Events without a name are about the watched directory itself, they
+      // are already reported by the watch on its parent.
+      if (event->len == 0) {
+        continue;
+      }
+
+      auto path = (it->second == "/" ? std::string{} : it->second) + "/" +
+                  std::string{event->name};
+      bool is_directory = (event->mask & IN_ISDIR) != 0;
+
+      if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+        Report(ChangeType::kAdded, path);
+        if (is_directory) {
+          AddWatch(path, true);
+        }
+      } else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+        Report(ChangeType::kRemoved, path);
+        if (is_directory) {
+          RemoveWatches(path);
+        }
+      } else if ((event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) != 0) {
+        Report(ChangeType::kModified, path);
+      }
+    }
+  }
+
+  // Changes cancelled in the same batch have an empty path.
+  std::erase_if(changes_, [](const StorageChange& change) {
+    return change.path.empty();
+  });
+  change_indices_.clear();
+  return std::exchange(changes_, {});
+}
+
+auto InotifyWatcher::AddWatch(const std::string& path, bool report_content)
+    -> void {
+  CHR_ZONE_SCOPED();
+
+  std::filesystem::path native_path{base_path_};
+  native_path.concat(path);
+
+  // inotify is not recursive, every directory has its own watch.
+  auto wd = inotify_add_watch(fd_, native_path.c_str(), kInotifyWatchMask);
+  if (wd == -1) {
+    log::Warn("Failed to watch {}: {}", path,
+              std::generic_category().message(errno));
+    return;
+  }
+
+  watches_[wd] = path;
+
+  // The content of a new directory can be written before its watch is added,
+  // so it's reported here.
+  std::error_code error{};
+  std::filesystem::directory_iterator iterator{native_path, error};
+  if (error) {
+    return;
+  }
+
+  std::string parent{path == "/" ? "" : path};
+  for (const auto& dir_entry : iterator) {
+    auto child = parent + "/" + dir_entry.path().filename().string();
+    if (report_content) {
+      Report(ChangeType::kAdded, child);
+    }
+
+    if (dir_entry.is_directory(error)) {
+      AddWatch(child, report_content);
+    }
+  }
+}
+
+auto InotifyWatcher::RemoveWatches(const std::string& path) -> void {
+  // A directory moved out of the storage is still watched by the kernel.
+  auto prefix = path + "/";
+  std::erase_if(watches_, [this, &path, &prefix](const auto& watch) {
+    if (watch.second != path && !watch.second.starts_with(prefix)) {
+      return false;
+    }
+
+    inotify_rm_watch(fd_, watch.first);
+    return true;
+  });
+}
+
+#else
+
+InotifyWatcher::InotifyWatcher(std::filesystem::path base_path)
+    : base_path_{std::move(base_path)} {
+  throw std::system_error(std::make_error_code(std::errc::not_supported),
+                          "Storage watch is not supported");
+}
+
+InotifyWatcher::~InotifyWatcher() = default;
+
+auto InotifyWatcher::IsSupported() -> bool { return false; }
+
+auto InotifyWatcher::Poll() -> std::vector<StorageChange> { return {}; }
+
+auto InotifyWatcher::AddWatch(const std::string& /*path*/,
+                              bool /*report_content*/) -> void {}
+
+auto InotifyWatcher::RemoveWatches(const std::string& /*path*/) -> void {}
+
+#endif
+
+auto InotifyWatcher::Report(ChangeType type, std::string path) -> void {
+  // Changes are merged by path, so a file written many times between two
+  // polls is reported once.
+  auto [it, inserted] = change_indices_.try_emplace(path, changes_.size());
+  if (inserted) {
+    changes_.push_back({.type = type, .path = std::move(path)});
+    return;
+  }
+
+  auto& change = changes_[it->second];
+  if (change.type == ChangeType::kAdded && type == ChangeType::kRemoved) {
+    // Created and deleted, the consumers never knew about it.
+    change.path.clear();
+    change_indices_.erase(it);
+  } else if (change.type == ChangeType::kRemoved &&
+             type == ChangeType::kAdded) {
+    change.type = ChangeType::kModified;
+  } else if (change.type != ChangeType::kAdded) {
+    change.type = type;
+  }
+}
+
+}  // namespace chr::storage::internal
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#ifndef CHR_STORAGE_WATCH_INOTIFY_WATCHER_H_
+#define CHR_STORAGE_WATCH_INOTIFY_WATCHER_H_
+
+#include <filesystem>
+#include <unordered_map>
+
+#include "pch.h"
+#include "watch.h"
+
+namespace chr::storage::internal {
+
+struct InotifyWatcher {
+  explicit InotifyWatcher(std::filesystem::path base_path);
+
+  InotifyWatcher(const InotifyWatcher&) = delete;
+  InotifyWatcher(InotifyWatcher&& other) noexcept = delete;
+
+  ~InotifyWatcher();
+
+  InotifyWatcher& operator=(const InotifyWatcher&) = delete;
+  InotifyWatcher& operator=(InotifyWatcher&& other) noexcept = delete;
+
+  static auto IsSupported() -> bool;
+
+  auto Poll() -> std::vector<StorageChange>;
+
+ private:
+  auto AddWatch(const std::string& path, bool report_content) -> void;
+  auto RemoveWatches(const std::string& path) -> void;
+  auto Report(ChangeType type, std::string path) -> void;
+
+  std::filesystem::path base_path_;
+  int fd_{-1};
+  std::unordered_map<int, std::string> watches_{};
+  std::vector<StorageChange> changes_{};
+  std::unordered_map<std::string, size_t> change_indices_{};
+};
+
+}  // namespace chr::storage::internal
+
+#endif  // CHR_STORAGE_WATCH_INOTIFY_WATCHER_H_
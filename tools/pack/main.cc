@@ -0,0 +1,46 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include <chronicle/common.h>
+#include <chronicle/storage.h>
+
+auto main(int argc, char* argv[]) -> int {
+  std::vector<std::string_view> args{argv + 1, argv + argc};
+
+  auto compression = chr::storage::PackCompression::kNone;
+  std::string_view trace_path{};
+  while (!args.empty() && args.front().starts_with("--")) {
+    if (args.front() == "--compress") {
+      compression = chr::storage::PackCompression::kLz;
+    } else if (args.front() == "--trace" && args.size() > 1) {
+      trace_path = args[1];
+      args.erase(args.begin());
+    } else {
+      break;
+    }
+    args.erase(args.begin());
+  }
+
+  if (args.size() != 2) {
+    chr::log::Err(
+        "usage: chronicle-pack [--compress] [--trace <access trace>] <input "
+        "directory> <output file>");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    chr::storage::PackWriter writer{};
+    writer.AddDirectory(args[0], "/", compression);
+    if (!trace_path.empty()) {
+      writer.SetFileOrder(chr::storage::AccessTrace::Load(trace_path));
+    }
+    writer.Write(args[1]);
+  } catch (const std::exception& e) {
+    chr::log::Err("{}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  chr::log::Info("pack {} created", args[1]);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include <chronicle/common.h>
+#include <chronicle/renderer.h>
+#include <chronicle/storage.h>
+
+#include <fstream>
+#include <set>
+
+// Number of bytes on every line of the generated arrays.
+constexpr size_t kBytesPerLine = 12;
+
+static auto GetShaderStage(std::string_view path)
+    -> std::optional<chr::renderer::ShaderStage> {
+  if (path.ends_with(".vert")) {
+    return chr::renderer::ShaderStage::kVertex;
+  }
+  if (path.ends_with(".frag")) {
+    return chr::renderer::ShaderStage::kFragment;
+  }
+  if (path.ends_with(".comp")) {
+    return chr::renderer::ShaderStage::kCompute;
+  }
+  return std::nullopt;
+}
+
+static auto GetStageName(chr::renderer::ShaderStage stage) -> std::string_view {
+  switch (stage) {
+    case chr::renderer::ShaderStage::kVertex:
+      return "kVertex";
+    case chr::renderer::ShaderStage::kFragment:
+      return "kFragment";
+    default:
+      return "kCompute";
+  }
+}
+
+// Write a Makefile dependency rule, it's read by CMake to rebuild the output
+// when a shader or one of its includes changes.
+static auto WriteDepfile(const std::filesystem::path& path,
+                         std::string_view output,
+                         const std::set<std::filesystem::path>& dependencies)
+    -> void {
+  auto escape = [](std::string text) {
+    std::string escaped{};
+    for (char c : text) {
+      if (c == ' ' || c == '#') {
+        escaped.push_back('\\');
+      }
+      escaped.push_back(c);
+    }
+    return escaped;
+  };
+
+  std::ofstream stream(path, std::ios::binary);
+  stream << escape(std::string{output}) << ":";
+  for (const auto& dependency : dependencies) {
+    stream << " \\\n  " << escape(dependency.generic_string());
+  }
+  stream << "\n";
+}
+
+auto main(int argc, char* argv[]) -> int {
+  std::vector<std::string_view> args{argv + 1, argv + argc};
+
+  std::string_view root = ".";
+  std::string_view depfile_path{};
+  chr::renderer::CompileSharerOptions options{};
+  while (args.size() > 1 && args.front().starts_with("--")) {
+    if (args.front() == "--root") {
+      root = args[1];
+    } else if (args.front() == "--include") {
+      options.include_directories.emplace_back(args[1]);
+    } else if (args.front() == "--pass") {
+      options.optimizer_passes.emplace_back(args[1]);
+    } else if (args.front() == "--depfile") {
+      depfile_path = args[1];
+    } else {
+      break;
+    }
+    args.erase(args.begin(), args.begin() + 2);
+  }
+
+  if (args.size() < 2) {
+    chr::log::Err(
+        "usage: chronicle-shader-bake [--root <directory>] [--include "
+        "<directory>] [--pass <spirv-opt flag>] [--depfile <file>] <output "
+        "file> <shader>...");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    chr::storage::Storage storage{chr::storage::BackendType::kFileSystem};
+    storage.SetBasePath(root);
+
+    chr::renderer::ShaderCompiler compiler{};
+    compiler.SetIncludeStorage(&storage);
+
+    std::string arrays{};
+    std::string table{};
+    std::set<std::filesystem::path> dependencies{};
+
+    for (size_t i = 1; i < args.size(); ++i) {
+      auto path = chr::storage::NormalizePath(args[i]);
+      auto stage = GetShaderStage(path);
+      if (!stage.has_value()) {
+        throw std::runtime_error(
+            fmt::format("Unknown stage of shader {}, the extension must be "
+                        ".vert, .frag or .comp",
+                        path));
+      }
+
+      auto file = storage.GetFile(path, chr::storage::FileMode::kMapped);
+      file.Open();
+      auto result = compiler.Compile(file.ReadAll(), path, *stage, options);
+      if (!result.success) {
+        throw std::runtime_error(fmt::format("Failed to compile {}", path));
+      }
+
+      chr::log::Info("{}: {} -> {} bytes, {} -> {} instructions", path,
+                     result.unoptimized.size, result.optimized.size,
+                     result.unoptimized.instruction_count,
+                     result.optimized.instruction_count);
+
+      dependencies.insert(storage.GetNativePath(path));
+      for (const auto& include : result.includes) {
+        dependencies.insert(storage.GetNativePath(include.path));
+      }
+
+      arrays += fmt::format("alignas(4) constexpr uint8_t kShader{}[] = {{", i);
+      for (size_t j = 0; j < result.data.size(); ++j) {
+        arrays += j % kBytesPerLine == 0 ? "\n    " : " ";
+        arrays += fmt::format("{:#04x},", result.data[j]);
+      }
+      arrays += "\n};\n\n";
+
+      table += fmt::format(
+          "    chr::renderer::BakedShader{{\n"
+          "        .path = \"{}\",\n"
+          "        .stage = chr::renderer::ShaderStage::{},\n"
+          "        .data = kShader{}}},\n",
+          path, GetStageName(*stage), i);
+    }
+
+    std::ofstream stream(std::filesystem::path{args[0]}, std::ios::binary);
+    stream << "// Generated by chronicle-shader-bake, do not edit.\n\n"
+           << "#include <chronicle/renderer.h>\n\n"
+           << "namespace {\n\n"
+           << arrays << "constexpr std::array kShaders{\n"
+           << table << "};\n\n"
+           << "[[maybe_unused]] const bool kRegistered = [] {\n"
+           << "  chr::renderer::BakedShaders::Register(kShaders);\n"
+           << "  return true;\n"
+           << "}();\n\n"
+           << "}  // namespace\n";
+    stream.close();
+    if (stream.fail()) {
+      throw std::runtime_error(fmt::format("Failed to write {}", args[0]));
+    }
+
+    if (!depfile_path.empty()) {
+      WriteDepfile(depfile_path, args[0], dependencies);
+    }
+  } catch (const std::exception& e) {
+    chr::log::Err("{}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  chr::log::Info("{} shaders baked into {}", args.size() - 1, args[0]);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+// Copyright (c) 2022 Sandro Cavazzoni.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+
+#include <chronicle/common.h>
+#include <chronicle/storage.h>
+
+#include <charconv>
+#include <chrono>
+
+#if defined(CHR_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Size of the reads made by the benchmark.
+constexpr size_t kChunkSize = 1024 * 1024;
+
+// Size of the pages touched in the memory pressure ballast.
+constexpr size_t kPageSize = 4096;
+
+// Read one byte of every page of the ballast. The reads are volatile, so the
+// compiler can't drop the ballast and the memory stays resident.
+static auto TouchPages(const std::vector<uint8_t>& ballast) -> void {
+  const volatile uint8_t* data = ballast.data();
+  for (size_t i = 0; i < ballast.size(); i += kPageSize) {
+    static_cast<void>(data[i]);
+  }
+}
+
+// Get the number of pages of a file in the page cache. With evict the pages
+// are dropped first, so every run starts cold.
+static auto GetCachedPages(const std::filesystem::path& path, bool evict)
+    -> size_t {
+#if defined(CHR_PLATFORM_LINUX)
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return 0;
+  }
+
+  if (evict) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  }
+
+  auto size = static_cast<size_t>(lseek(fd, 0, SEEK_END));
+  auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t cached = 0;
+  if (auto* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      data != MAP_FAILED) {
+    std::vector<unsigned char> pages((size + page_size - 1) / page_size);
+    if (mincore(data, size, pages.data()) == 0) {
+      cached = static_cast<size_t>(
+          std::ranges::count_if(pages, [](auto page) { return page & 1; }));
+    }
+    munmap(data, size);
+  }
+
+  close(fd);
+  return cached;
+#else
+  return 0;
+#endif
+}
+
+static auto Run(const chr::storage::Storage& storage, std::string_view path,
+                chr::storage::FileMode mode, std::string_view name,
+                const std::filesystem::path& native_path) -> void {
+  GetCachedPages(native_path, true);
+
+  auto start = std::chrono::steady_clock::now();
+
+  auto file = storage.GetFile(path, mode);
+  file.Open();
+  file.Seek(0, chr::storage::SeekDir::kEnd);
+  auto size = file.Position();
+  file.Seek(0, chr::storage::SeekDir::kBegin);
+
+  std::vector<uint8_t> buffer(kChunkSize);
+  for (size_t offset = 0; offset < size; offset += buffer.size()) {
+    file.Read(buffer.data(), std::min(buffer.size(), size - offset));
+  }
+  file.Close();
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  auto mib = static_cast<double>(size) / (1024.0 * 1024.0);
+  chr::log::Info("{}: {:.1f} MiB in {:.3f} s, {:.1f} MiB/s, {} pages cached",
+                 name, mib, elapsed.count(), mib / elapsed.count(),
+                 GetCachedPages(native_path, false));
+}
+
+// Store the file in a raw and in a compressed pack, then read it back from
+// both, so the cost of the decompression can be compared with the I/O saved.
+static auto RunPacks(const chr::storage::Storage& storage,
+                     std::string_view path) -> void {
+  auto file = storage.GetFile(path, chr::storage::FileMode::kStream);
+  file.Open();
+  auto data = file.ReadAll();
+  file.Close();
+
+  constexpr std::array kPacks{
+      std::pair{chr::storage::PackCompression::kNone, "pack raw"},
+      std::pair{chr::storage::PackCompression::kLz, "pack compressed"}};
+
+  for (const auto& [compression, name] : kPacks) {
+    auto pack_path = std::filesystem::temp_directory_path() /
+                     fmt::format("chronicle-storage-bench-{}.pack",
+                                 static_cast<int>(compression));
+
+    chr::storage::PackWriter writer{};
+    writer.AddFile(path, data, compression);
+    writer.Write(pack_path);
+
+    chr::log::Info("{}: {:.1f} MiB on disk", name,
+                   static_cast<double>(std::filesystem::file_size(pack_path)) /
+                       (1024.0 * 1024.0));
+
+    chr::storage::Storage pack{chr::storage::BackendType::kPack};
+    pack.SetBasePath(pack_path.string());
+    Run(pack, path, chr::storage::FileMode::kStream, name, pack_path);
+
+    std::filesystem::remove(pack_path);
+  }
+}
+
+auto main(int argc, char* argv[]) -> int {
+  std::vector<std::string_view> args{argv + 1, argv + argc};
+
+  // Memory allocated and touched before the runs, so the page cache has
+  // less room.
+  size_t pressure = 0;
+  auto packs = false;
+  while (!args.empty() && args.front().starts_with("--")) {
+    if (args.front() == "--pressure" && args.size() > 1) {
+      std::from_chars(args[1].data(), args[1].data() + args[1].size(),
+                      pressure);
+      args.erase(args.begin());
+    } else if (args.front() == "--packs") {
+      packs = true;
+    } else {
+      break;
+    }
+    args.erase(args.begin());
+  }
+
+  if (args.size() != 2) {
+    chr::log::Err(
+        "usage: chronicle-storage-bench [--pressure <MiB>] [--packs] <base "
+        "directory> <file path>");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    std::vector<uint8_t> ballast(pressure * 1024 * 1024, 1);
+
+    chr::storage::Storage storage{chr::storage::BackendType::kFileSystem};
+    storage.SetBasePath(args[0]);
+
+    auto native_path = storage.GetNativePath(args[1]);
+    Run(storage, args[1], chr::storage::FileMode::kStream, "buffered",
+        native_path);
+    Run(storage, args[1], chr::storage::FileMode::kMapped, "mapped",
+        native_path);
+    Run(storage, args[1], chr::storage::FileMode::kDirect, "direct",
+        native_path);
+
+    if (packs) {
+      RunPacks(storage, args[1]);
+    }
+
+    TouchPages(ballast);
+  } catch (const std::exception& e) {
+    chr::log::Err("{}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}